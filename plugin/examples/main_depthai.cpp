@@ -1,14 +1,27 @@
 #include "../include/spectacularAI/unity/depthai.hpp"
+#include "../include/spectacularAI/unity/mock.hpp"
 
 #include <spectacularAI/output.hpp>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <vector>
 
+/**
+ * Usage: main_depthai [--mock [--fast]]
+ * --mock uses the synthetic backend instead of a device, --fast also drops the real time pacing
+ */
 int main(int argc, char *argv[]) {
     ConfigurationWrapper config;
     config.lowLatency = true;
 
+    bool useMock = false;
+    MockBackendConfigWrapper mock;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--mock") == 0) useMock = true;
+        else if (std::strcmp(argv[i], "--fast") == 0) mock.realTime = false;
+    }
+
     // SLAM callback
     callback_t_mapper_output onMapperOutput = [](const MapperOutputWrapper* mapperOutput) {
         const int64_t* updatedKeyFrames;
@@ -21,7 +34,7 @@ int main(int argc, char *argv[]) {
         sai_mapper_output_release(mapperOutput); // must release memory!
     };
 
-    PipelineWrapper* pipeline = sai_depthai_pipeline_build(&config, nullptr, 0, onMapperOutput);
+    PipelineWrapper* pipeline = sai_depthai_pipeline_build(&config, nullptr, 0, onMapperOutput, useMock ? &mock : nullptr);
     spectacularAI::daiPlugin::Session* session = sai_depthai_pipeline_start_session(pipeline, nullptr);
 
     int counter = 0;
@@ -35,6 +48,12 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    MockSessionStatsWrapper stats;
+    if (sai_depthai_session_get_mock_stats(session, &stats)) {
+        std::cout << "mock: " << stats.outputs << " outputs (" << stats.droppedOutputs << " dropped), "
+            << stats.keyFrames << " keyframes in " << stats.wallSeconds << " s" << std::endl;
+    }
+
     sai_depthai_session_release(session); // must release memory!
     sai_depthai_pipeline_release(pipeline); // must release memory!
 
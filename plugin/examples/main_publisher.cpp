@@ -0,0 +1,36 @@
+#include "../include/spectacularAI/unity/replay.hpp"
+#include "../include/spectacularAI/unity/publisher.hpp"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: ./main_publisher path/to/recording [/shm_name] [ring_capacity]" << std::endl;
+        return 1;
+    }
+
+    std::string dataFolder = argv[1];
+    std::string name = argc > 2 ? argv[2] : "/sai_pose";
+    int ringCapacity = argc > 3 ? std::stoi(argv[3]) : 1024;
+
+    char errorMsg[1000];
+    PosePublisher* publisher = sai_pose_publisher_create(name.c_str(), ringCapacity, errorMsg);
+    if (!publisher) {
+        std::cerr << "Failed to create publisher: " << errorMsg << std::endl;
+        return 1;
+    }
+
+    spectacularAI::Replay* replayHandle = sai_replay_build(dataFolder.c_str(), "", nullptr, nullptr);
+    sai_replay_set_playback_speed(replayHandle, 1.0);
+    sai_pose_publisher_attach_replay(publisher, replayHandle, nullptr);
+
+    std::cout << "Publishing to " << name << std::endl;
+    while (sai_replay_one_line(replayHandle));
+    std::cout << "Published " << sai_pose_publisher_get_published_count(publisher) << " poses" << std::endl;
+
+    sai_replay_release(replayHandle); // must release memory!
+    sai_pose_publisher_release(publisher); // must release memory!
+
+    return 0;
+}
@@ -0,0 +1,392 @@
+#include "../include/spectacularAI/unity/replay.hpp"
+#include "../include/spectacularAI/unity/anchors.hpp"
+#include "../include/spectacularAI/unity/util.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+    #pragma comment(lib, "psapi.lib")
+#else
+    #include <unistd.h>
+#endif
+
+/**
+ * Soak test: replays a recording in a loop for a given duration through the C API
+ * and checks that memory, live handles and output latency do not drift.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Settings {
+    std::string dataFolder;
+    std::string configurationYAML = "useSlam: True\n";
+    double durationMinutes = 60.0;
+    double sampleIntervalSeconds = 60.0;
+    double maxRssGrowthMb = 50.0;
+    int64_t maxHandleGrowth = 100;
+    double maxP99DriftMs = 5.0;
+};
+
+struct Sample {
+    double elapsedSeconds;
+    double rssMb;
+    int64_t liveHandles;
+    double p50Ms;
+    double p99Ms;
+    int64_t outputs;
+    int64_t mapperOutputs;
+};
+
+// Wall clock time when each input line was fed to the replay, keyed by its data timestamp
+struct InputTime {
+    double time;
+    Clock::time_point fedAt;
+};
+
+constexpr size_t MAX_INPUT_TIMES = 4096;
+constexpr double MAX_INPUT_TIME_LOOKBACK = 1.0; // seconds of data time, inputs are nearly sorted
+
+struct State {
+    std::mutex mutex;
+    std::vector<double> latenciesMs;
+    std::deque<InputTime> inputTimes;
+    std::atomic<int64_t> outputs { 0 };
+    std::atomic<int64_t> mapperOutputs { 0 };
+    AnchorSet* anchors = nullptr;
+    bool anchorAdded = false;
+};
+
+State state;
+
+double read_rss_mb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize / (1024.0 * 1024.0);
+#else
+    long pages = 0, residentPages = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &residentPages) != 2) residentPages = 0;
+    fclose(f);
+    return residentPages * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+#endif
+}
+
+int64_t total_live_handles() {
+    HandleCountsWrapper c = sai_get_live_handle_counts();
+    return c.vioOutputs + c.cameraPoses + c.cameras + c.mapperOutputs + c.maps
+        + c.keyFrames + c.frameSets + c.frames + c.pointClouds;
+}
+
+double percentile(std::vector<double> &values, double p) {
+    if (values.empty()) return 0;
+    size_t k = std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+void exercise_camera(const CameraWrapper* camera) {
+    if (!camera) return;
+    Matrix3dWrapper intrinsics = sai_camera_get_intrinsic_matrix(camera);
+    sai_camera_get_projection_matrix_opengl(camera, 0.01, 100.0);
+    spectacularAI::PixelCoordinates pixel { (float)intrinsics.m02, (float)intrinsics.m12 };
+    spectacularAI::Vector3d ray;
+    if (sai_camera_pixel_to_ray(camera, &pixel, &ray)) {
+        sai_camera_ray_to_pixel(camera, &ray, &pixel);
+    }
+
+    CameraWrapper* pinhole = sai_camera_build_pinhole(intrinsics, 640, 400);
+    sai_camera_release(pinhole); // must release memory!
+}
+
+void exercise_camera_pose(spectacularAI::CameraPose* cameraPose) {
+    if (!cameraPose) return;
+    spectacularAI::Pose pose = sai_camera_pose_get_pose(cameraPose);
+    sai_camera_pose_get_velocity(cameraPose);
+    sai_camera_pose_get_world_to_camera_matrix(cameraPose);
+    Matrix4dWrapper cameraToWorld = sai_camera_pose_get_camera_to_world_matrix(cameraPose);
+    sai_camera_pose_get_position(cameraPose);
+    sai_pose_from_matrix(pose.time, cameraToWorld);
+    sai_pose_as_matrix(pose.position, pose.orientation);
+
+    const CameraWrapper* camera = sai_camera_pose_get_camera(cameraPose);
+    exercise_camera(camera);
+    sai_camera_release(camera); // must release memory!
+    sai_camera_pose_release(cameraPose); // must release memory!
+}
+
+void exercise_frame(FrameWrapper* frame) {
+    if (!frame) return;
+    sai_frame_get_depth_scale(frame);
+    exercise_camera_pose(sai_frame_get_camera_pose(frame));
+    sai_frame_release(frame); // must release memory!
+}
+
+void exercise_point_cloud(PointCloudWrapper* pointCloud) {
+    if (!pointCloud) return;
+    int n = sai_point_cloud_get_size(pointCloud);
+    if (!sai_point_cloud_empty(pointCloud) && n > 0) {
+        volatile float sum = 0;
+        const spectacularAI::Vector3f* positions = sai_point_cloud_get_position_data(pointCloud);
+        sum = sum + positions[0].x + positions[n - 1].z;
+        if (sai_point_cloud_has_normals(pointCloud)) {
+            const spectacularAI::Vector3f* normals = sai_point_cloud_get_normal_data(pointCloud);
+            sum = sum + normals[n - 1].x;
+        }
+        if (sai_point_cloud_has_colors(pointCloud)) {
+            const std::uint8_t* colors = sai_point_cloud_get_rgb24_data(pointCloud);
+            sum = sum + colors[3 * n - 1];
+        }
+    }
+    sai_point_cloud_release(pointCloud); // must release memory!
+}
+
+/** Data timestamp of a data.jsonl line, false if it has none */
+bool parse_line_time(const std::string &line, double &time) {
+    size_t key = line.find("\"time\"");
+    if (key == std::string::npos) return false;
+    size_t colon = line.find(':', key);
+    if (colon == std::string::npos) return false;
+    char* end = nullptr;
+    time = std::strtod(line.c_str() + colon + 1, &end);
+    return end != line.c_str() + colon + 1;
+}
+
+void record_input_time(double time) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.inputTimes.push_back(InputTime { time, Clock::now() });
+    if (state.inputTimes.size() > MAX_INPUT_TIMES) state.inputTimes.pop_front();
+}
+
+/**
+ * Latency from feeding the input that produced the output (the earliest input at or after
+ * the output timestamp, i.e. its camera frame) to the output callback. Call with the mutex locked.
+ */
+bool output_latency_ms(double outputTime, Clock::time_point now, double &latencyMs) {
+    const InputTime* source = nullptr;
+    for (auto it = state.inputTimes.rbegin(); it != state.inputTimes.rend(); ++it) {
+        if (it->time < outputTime - MAX_INPUT_TIME_LOOKBACK) break;
+        if (it->time >= outputTime - 1e-6 && (!source || it->time <= source->time)) source = &*it;
+    }
+    // Extrapolated outputs are ahead of every input, attribute them to the latest one
+    if (!source && !state.inputTimes.empty() && state.inputTimes.back().time < outputTime) {
+        source = &state.inputTimes.back();
+    }
+    if (!source) return false;
+    latencyMs = std::chrono::duration<double, std::milli>(now - source->fedAt).count();
+    return true;
+}
+
+void on_vio_output(const VioOutputWrapper* output) {
+    const Clock::time_point now = Clock::now();
+    spectacularAI::Pose outputPose = sai_vio_output_get_pose(output);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        double latencyMs;
+        if (output_latency_ms(outputPose.time, now, latencyMs)) state.latenciesMs.push_back(latencyMs);
+    }
+    ++state.outputs;
+
+    sai_vio_output_get_tracking_status(output);
+    sai_vio_output_get_velocity(output);
+    sai_vio_output_get_angular_velocity(output);
+    sai_vio_output_get_acceleration(output);
+    sai_vio_output_get_position_covariance(output);
+    sai_vio_output_get_velocity_covariance(output);
+    sai_vio_output_get_tag(output);
+    exercise_camera_pose(sai_vio_output_get_camera_pose(output, 0));
+    sai_vio_output_release(output); // must release memory!
+}
+
+void on_mapper_output(const MapperOutputWrapper* mapperOutput) {
+    ++state.mapperOutputs;
+
+    const int64_t* updatedKeyFrames;
+    int32_t nUpdated = sai_mapper_output_get_updated_key_frames(mapperOutput, &updatedKeyFrames);
+    sai_mapper_output_get_final_map(mapperOutput);
+
+    MapWrapper* map = sai_mapper_output_get_map(mapperOutput);
+    int32_t n = sai_map_get_key_frame_count(map);
+    std::vector<const KeyFrameWrapper*> keyFrames(n);
+    sai_map_get_key_frames(map, keyFrames.data());
+    for (const KeyFrameWrapper* keyFrame : keyFrames) {
+        int64_t id = sai_key_frame_get_id(keyFrame);
+        bool updated = std::find(updatedKeyFrames, updatedKeyFrames + nUpdated, id) != updatedKeyFrames + nUpdated;
+        if (updated) {
+            sai_key_frame_get_angular_velocity(keyFrame);
+            FrameSetWrapper* frameSet = sai_key_frame_get_frame_set(keyFrame);
+            exercise_frame(sai_frame_set_get_primary_frame(frameSet));
+            exercise_frame(sai_frame_set_get_secondary_frame(frameSet));
+            exercise_frame(sai_frame_set_get_rgb_frame(frameSet));
+            exercise_frame(sai_frame_set_get_depth_frame(frameSet));
+            sai_frame_set_release(frameSet); // must release memory!
+            exercise_point_cloud(sai_key_frame_get_point_cloud(keyFrame));
+        }
+        sai_key_frame_release(keyFrame); // must release memory!
+    }
+
+    if (!state.anchorAdded && n > 0) {
+        spectacularAI::Pose origin {};
+        origin.orientation.w = 1.0;
+        sai_anchor_set_add(state.anchors, map, origin);
+        state.anchorAdded = true;
+    }
+    const AnchorUpdateWrapper* anchorUpdates;
+    sai_anchor_set_update(state.anchors, mapperOutput, &anchorUpdates);
+
+    sai_map_release(map); // must release memory!
+    sai_mapper_output_release(mapperOutput); // must release memory!
+}
+
+Sample take_sample(double elapsedSeconds) {
+    Sample s;
+    s.elapsedSeconds = elapsedSeconds;
+    s.rssMb = read_rss_mb();
+    s.liveHandles = total_live_handles();
+    std::vector<double> latencies;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        latencies.swap(state.latenciesMs);
+    }
+    s.p50Ms = percentile(latencies, 0.50);
+    s.p99Ms = percentile(latencies, 0.99);
+    s.outputs = state.outputs;
+    s.mapperOutputs = state.mapperOutputs;
+    return s;
+}
+
+void print_sample(const Sample &s) {
+    std::printf("%8.0fs  rss=%8.1f MB  handles=%6lld  p50=%7.3f ms  p99=%7.3f ms  outputs=%lld  mapper=%lld\n",
+        s.elapsedSeconds, s.rssMb, (long long)s.liveHandles, s.p50Ms, s.p99Ms,
+        (long long)s.outputs, (long long)s.mapperOutputs);
+    std::fflush(stdout);
+}
+
+bool parse_args(int argc, char *argv[], Settings &settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--duration-minutes" && hasValue) settings.durationMinutes = std::atof(argv[++i]);
+        else if (arg == "--sample-interval" && hasValue) settings.sampleIntervalSeconds = std::atof(argv[++i]);
+        else if (arg == "--max-rss-growth-mb" && hasValue) settings.maxRssGrowthMb = std::atof(argv[++i]);
+        else if (arg == "--max-handle-growth" && hasValue) settings.maxHandleGrowth = std::atoll(argv[++i]);
+        else if (arg == "--max-p99-drift-ms" && hasValue) settings.maxP99DriftMs = std::atof(argv[++i]);
+        else if (arg == "--config" && hasValue) settings.configurationYAML = argv[++i];
+        else if (!arg.empty() && arg[0] != '-' && settings.dataFolder.empty()) settings.dataFolder = arg;
+        else return false;
+    }
+    return !settings.dataFolder.empty() && settings.sampleIntervalSeconds > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[]) {
+    Settings settings;
+    if (!parse_args(argc, argv, settings)) {
+        std::cout << "Usage: ./main_soak path/to/recording [--duration-minutes 60] [--sample-interval 60]" << std::endl
+            << "    [--max-rss-growth-mb 50] [--max-handle-growth 100] [--max-p99-drift-ms 5] [--config yaml]" << std::endl;
+        return 1;
+    }
+
+    state.anchors = sai_anchor_set_create(2, 1e-4, 1e-4);
+
+    const Clock::time_point start = Clock::now();
+    const auto duration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(settings.durationMinutes * 60.0));
+    const auto sampleInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(settings.sampleIntervalSeconds));
+    Clock::time_point nextSample = start + sampleInterval;
+    std::vector<Sample> samples;
+    int replays = 0;
+
+    char errorMsg[1000];
+    while (Clock::now() - start < duration) {
+        spectacularAI::Replay* replayHandle = sai_replay_build(
+            settings.dataFolder.c_str(),
+            settings.configurationYAML.c_str(),
+            on_mapper_output,
+            errorMsg);
+        if (!replayHandle) {
+            std::cerr << "Failed to build replay: " << errorMsg << std::endl;
+            return 1;
+        }
+        sai_replay_set_output_callback(replayHandle, on_vio_output);
+
+        // Read data.jsonl in step with the replay to know the timestamp of each line fed
+        std::ifstream data(settings.dataFolder + "/data.jsonl");
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.inputTimes.clear();
+        }
+
+        bool more = true;
+        std::string line;
+        while (more && Clock::now() - start < duration) {
+            double inputTime;
+            if (std::getline(data, line) && parse_line_time(line, inputTime)) record_input_time(inputTime);
+            more = sai_replay_one_line(replayHandle);
+
+            if (Clock::now() >= nextSample) {
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                samples.push_back(take_sample(elapsed));
+                print_sample(samples.back());
+                nextSample += sampleInterval;
+            }
+        }
+
+        sai_replay_release(replayHandle); // must release memory!
+        ++replays;
+    }
+
+    sai_anchor_set_release(state.anchors); // must release memory!
+
+    bool ok = true;
+    int64_t leakedHandles = total_live_handles();
+    std::cout << "replays=" << replays << " leaked handles=" << leakedHandles << std::endl;
+    if (leakedHandles != 0) {
+        std::cout << "FAIL: handles not released after the replay was released" << std::endl;
+        ok = false;
+    }
+
+    if (samples.size() < 2) {
+        std::cout << "WARNING: fewer than two samples, drift checks skipped" << std::endl;
+    } else {
+        // The first sample is the baseline, earlier memory use is warm-up
+        const Sample &first = samples.front();
+        const Sample &last = samples.back();
+        double rssGrowth = last.rssMb - first.rssMb;
+        int64_t handleGrowth = last.liveHandles - first.liveHandles;
+        double p99Drift = last.p99Ms - first.p99Ms;
+        std::printf("rss growth=%.1f MB  handle growth=%lld  p99 drift=%.3f ms\n",
+            rssGrowth, (long long)handleGrowth, p99Drift);
+        if (rssGrowth > settings.maxRssGrowthMb) {
+            std::cout << "FAIL: RSS growth exceeds " << settings.maxRssGrowthMb << " MB" << std::endl;
+            ok = false;
+        }
+        if (handleGrowth > settings.maxHandleGrowth) {
+            std::cout << "FAIL: live handle growth exceeds " << settings.maxHandleGrowth << std::endl;
+            ok = false;
+        }
+        if (p99Drift > settings.maxP99DriftMs) {
+            std::cout << "FAIL: p99 latency drift exceeds " << settings.maxP99DriftMs << " ms" << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+    return ok ? 0 : 1;
+}
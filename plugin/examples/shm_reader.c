@@ -0,0 +1,53 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/spectacularAI/unity/shm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Reads poses published by main_publisher from another process */
+int main(int argc, char *argv[]) {
+    const char* name = argc > 1 ? argv[1] : "/sai_pose";
+    double seconds = argc > 2 ? atof(argv[2]) : 10.0;
+
+    sai_shm_reader* reader = NULL;
+    while (reader == NULL) {
+        reader = sai_shm_reader_open(name);
+        if (reader == NULL) {
+            struct timespec wait = { 0, 100 * 1000 * 1000 };
+            nanosleep(&wait, NULL);
+        }
+    }
+
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t received = 0, dropped = 0, lastPrinted = 0;
+    double maxLatency = 0;
+    sai_shm_pose pose;
+    for (;;) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double t = now.tv_sec + now.tv_nsec * 1e-9;
+        if (t - (start.tv_sec + start.tv_nsec * 1e-9) > seconds) break;
+
+        while (sai_shm_reader_next(reader, &pose, &dropped)) {
+            ++received;
+            double latency = t - pose.publishTime;
+            if (latency > maxLatency) maxLatency = latency;
+        }
+
+        if (received - lastPrinted >= 100 && sai_shm_reader_latest(reader, &pose)) {
+            printf("#%llu t=%.3f position = %.3f, %.3f, %.3f\n", (unsigned long long)pose.sequence,
+                pose.time, pose.position[0], pose.position[1], pose.position[2]);
+            lastPrinted = received;
+        }
+
+        struct timespec poll = { 0, 200 * 1000 };
+        nanosleep(&poll, NULL);
+    }
+
+    printf("received=%llu dropped=%llu max latency=%.3f ms\n",
+        (unsigned long long)received, (unsigned long long)dropped, maxLatency * 1e3);
+    sai_shm_reader_close(reader);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "types.hpp"
+#include "mapping.hpp"
+
+/**
+ * World-anchored content that follows SLAM map corrections. Each anchor is attached to
+ * its nearest keyframe(s) and its pose is recomputed only when one of those keyframes
+ * is updated by the mapper.
+ */
+struct AnchorSet;
+
+/** Anchor whose pose changed during the latest mapper update */
+struct AnchorUpdateWrapper {
+    int64_t anchorId;
+    spectacularAI::Pose pose; // anchor->world
+};
+
+extern "C" {
+    /** AnchorSet API */
+    EXPORT_API AnchorSet* sai_anchor_set_create(
+        int32_t keyFramesPerAnchor,
+        double minPositionChange,
+        double minAngleChange);
+    EXPORT_API int64_t sai_anchor_set_add(
+        AnchorSet* anchorSetHandle,
+        const MapWrapper* mapHandle,
+        spectacularAI::Pose anchorToWorld);
+    EXPORT_API bool sai_anchor_set_remove(AnchorSet* anchorSetHandle, int64_t anchorId);
+    EXPORT_API bool sai_anchor_set_get_pose(
+        AnchorSet* anchorSetHandle,
+        int64_t anchorId,
+        spectacularAI::Pose* anchorToWorld);
+    EXPORT_API int32_t sai_anchor_set_get_count(AnchorSet* anchorSetHandle);
+    /** Returns the number of anchors that moved, the array is valid until the next call */
+    EXPORT_API int32_t sai_anchor_set_update(
+        AnchorSet* anchorSetHandle,
+        const MapperOutputWrapper* mapperOutputHandle,
+        const AnchorUpdateWrapper** updatedAnchorsHandle);
+    EXPORT_API void sai_anchor_set_release(AnchorSet* anchorSetHandle);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "types.hpp"
+#include "mapping.hpp"
+
+/**
+ * Compact, quantised point cloud encoding for visualisation, storage and transfer.
+ *
+ * - Positions: 3 x uint16 quantised over the keyframe's bounding box,
+ *   decoded = boundsMin + q * scale. Per-axis error is at most scale / 2 (plus float
+ *   rounding), i.e. extent / 131070: 0.08 mm for a 10 m extent.
+ * - Normals (optional): octahedral, 2 bytes (2 x int8 snorm, angular error below 1 deg)
+ *   or 4 bytes (2 x int16 snorm, below 0.004 deg).
+ * - Colors (optional): RGB565, error at most 4 (red, blue) and 2 (green) on the 0-255 scale.
+ *
+ * Bytes per point with colors, and the reduction against the SDK arrays (27 bytes with
+ * normals, 15 without):
+ *
+ *   normalBytes 2 (default): 10 bytes, 2.7x
+ *   normalBytes 4: 12 bytes, 2.25x
+ *   normalBytes 0: 8 bytes, 1.9x against an SDK cloud without normals (as in the tile store)
+ *
+ * The float render layout (see render.hpp) takes 32 bytes and the managed PointCloud
+ * arrays 40.
+ */
+struct CompactPointCloud;
+
+struct CompactPointCloudWrapper {
+    int32_t size;
+    int32_t normalBytes; // 0, 2 or 4
+    spectacularAI::Vector3f boundsMin;
+    spectacularAI::Vector3f scale; // quantisation step per axis
+    const std::uint16_t* positions; // 3 * size
+    const std::uint8_t* normals; // normalBytes * size, null if none
+    const std::uint16_t* colors; // size, RGB565, null if none
+    int64_t bytes; // total size of the buffers
+};
+
+extern "C" {
+    /** normalBytes 2 or 4 encodes the normals (if any), 0 drops them */
+    EXPORT_API CompactPointCloud* sai_point_cloud_encode_compact(
+        PointCloudWrapper* pointCloudHandle,
+        int32_t normalBytes);
+    /** Buffers are valid until the CompactPointCloud is released */
+    EXPORT_API void sai_compact_point_cloud_get(
+        const CompactPointCloud* compactPointCloudHandle,
+        CompactPointCloudWrapper* compactPointCloud);
+    /** Decode into caller owned arrays of `size` elements, keyframe camera coordinates as in PointCloud */
+    EXPORT_API void sai_compact_point_cloud_decode_positions(
+        const CompactPointCloud* compactPointCloudHandle,
+        spectacularAI::Vector3f* positions);
+    /** Returns false if there are no normals */
+    EXPORT_API bool sai_compact_point_cloud_decode_normals(
+        const CompactPointCloud* compactPointCloudHandle,
+        spectacularAI::Vector3f* normals);
+    /** 4 bytes per point. Returns false if there are no colors */
+    EXPORT_API bool sai_compact_point_cloud_decode_rgba32(
+        const CompactPointCloud* compactPointCloudHandle,
+        std::uint8_t* colors);
+    EXPORT_API void sai_compact_point_cloud_release(CompactPointCloud* compactPointCloudHandle);
+}
@@ -24,28 +24,36 @@ struct ConfigurationWrapper {
     bool lowLatency=false;
 };
 
+// See mock.hpp
+struct MockBackendConfigWrapper;
+struct MockBackend;
+
 struct PipelineWrapper {
     PipelineWrapper(
         std::shared_ptr<spectacularAI::daiPlugin::Pipeline> handle,
         std::shared_ptr<dai::Pipeline> pipeline,
         std::shared_ptr<dai::Device> device) : _handle(handle), _pipeline(pipeline), _device(device) {};
+    PipelineWrapper(std::shared_ptr<MockBackend> mock) : _mock(mock) {};
     const std::shared_ptr<spectacularAI::daiPlugin::Pipeline> getHandle() const { return _handle; }
     const std::shared_ptr<dai::Device> getDevice() const { return _device; }
+    const std::shared_ptr<MockBackend> getMock() const { return _mock; }
 
 private:
     const std::shared_ptr<spectacularAI::daiPlugin::Pipeline> _handle;
     const std::shared_ptr<dai::Pipeline> _pipeline;
     const std::shared_ptr<dai::Device> _device;
+    const std::shared_ptr<MockBackend> _mock;
 };
 
 extern "C"
 {
-    /** Pipeline API */
+    /** Pipeline API, a non-null `mockBackend` builds a synthetic pipeline that needs no device (see mock.hpp) */
     EXPORT_API PipelineWrapper* sai_depthai_pipeline_build(
         ConfigurationWrapper* configuration,
         const char** internalParameters,
         int internalParametersCount,
-        callback_t_mapper_output onMapperOutput);
+        callback_t_mapper_output onMapperOutput,
+        const MockBackendConfigWrapper* mockBackend);
     EXPORT_API spectacularAI::daiPlugin::Session* sai_depthai_pipeline_start_session(PipelineWrapper* pipelineHandle, char* errorMsg);
     EXPORT_API void sai_depthai_pipeline_release(PipelineWrapper* pipelineHandle);
 
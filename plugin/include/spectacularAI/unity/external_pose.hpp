@@ -0,0 +1,78 @@
+#pragma once
+
+#include <spectacularAI/depthai/plugin.hpp>
+#include "types.hpp"
+#include "output.hpp"
+
+/**
+ * Buffered ingestion of external absolute poses (e.g. motion capture or AprilTag detections).
+ * Batches are queued without blocking, a worker thread checks them against the VIO estimate,
+ * merges or decimates them to the fusion rate and forwards the result to the session's
+ * addAbsolutePose. The session must outlive the queue.
+ *
+ * Outlier gate: a sample is rejected if its position differs from the VIO position at the
+ * sample time by more than maxPositionError + 3 * sqrt(trace(positionCovariance)), or its
+ * orientation (when orientationVariance >= 0) by more than maxOrientationErrorDegrees plus
+ * three standard deviations. The gate is applied once gateAfterForwarded poses have been
+ * forwarded (before that VIO is not yet in the external frame), and only when VIO is tracking
+ * and has an output within maxTimeOffset seconds of the sample. After reacquireAfterRejections
+ * consecutive rejections VIO is assumed to have drifted away from the external frame, and the
+ * gate is reset: it stays open until gateAfterForwarded more poses have been forwarded.
+ */
+struct ExternalPoseQueue;
+
+enum class ExternalPoseMerge : int32_t {
+    LATEST = 0, // forward the newest sample of each fusion period
+    AVERAGE = 1 // forward the inverse-variance weighted mean of the period's samples
+};
+
+struct ExternalPoseQueueConfigWrapper {
+    double fusionRateHz=10.0; // forwarded poses per second, 0 forwards every accepted sample
+    ExternalPoseMerge merge=ExternalPoseMerge::AVERAGE;
+    double maxPositionError=0.5; // meters, 0 disables the position gate
+    double maxOrientationErrorDegrees=10.0; // 0 disables the orientation gate
+    double maxTimeOffset=0.25; // seconds, how far VIO outputs may be extrapolated for the gate
+    int32_t gateAfterForwarded=5;
+    int32_t reacquireAfterRejections=50; // consecutive outliers that reset the gate, 0 never resets
+    int32_t capacity=4096; // pending samples, samples beyond it are dropped
+};
+
+struct ExternalPoseWrapper {
+    spectacularAI::Pose pose; // monotonic seconds as VIO output times
+    Matrix3dWrapper positionCovariance;
+    double orientationVariance; // negative if the orientation is unknown
+};
+
+struct ExternalPoseQueueStatsWrapper {
+    int64_t received;
+    int64_t accepted; // passed the gate, including samples later merged away
+    int64_t rejected; // outliers and samples older than the last forwarded pose
+    int64_t reacquisitions; // gate resets after reacquireAfterRejections consecutive outliers
+    int64_t decimated; // accepted samples merged into or replaced by another
+    int64_t dropped; // queue full
+    int64_t forwarded;
+    int32_t pending;
+    double meanForwardMs; // time spent in addAbsolutePose
+    double maxForwardMs;
+};
+
+extern "C" {
+    /** Returns null on failure, `errorMsg` (1000 chars) describes why */
+    EXPORT_API ExternalPoseQueue* sai_external_pose_queue_create(
+        spectacularAI::daiPlugin::Session* sessionHandle,
+        const ExternalPoseQueueConfigWrapper* config,
+        char* errorMsg);
+    /** Latest VIO estimate for the outlier gate, call for every (or most) session outputs */
+    EXPORT_API void sai_external_pose_queue_add_vio_output(
+        ExternalPoseQueue* queueHandle,
+        const VioOutputWrapper* vioOutputHandle);
+    /** Queue a batch ordered by time, returns the number of samples queued (the rest were dropped) */
+    EXPORT_API int32_t sai_external_pose_queue_push(
+        ExternalPoseQueue* queueHandle,
+        const ExternalPoseWrapper* poses,
+        int32_t count);
+    /** Block until queued samples have been processed and the open fusion period forwarded */
+    EXPORT_API void sai_external_pose_queue_flush(ExternalPoseQueue* queueHandle);
+    EXPORT_API ExternalPoseQueueStatsWrapper sai_external_pose_queue_get_stats(ExternalPoseQueue* queueHandle);
+    EXPORT_API void sai_external_pose_queue_release(ExternalPoseQueue* queueHandle);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "types.hpp"
+#include "mapping.hpp"
+
+/**
+ * Conversions from frame images (see sai_frame_get_image) into upload-ready texture
+ * layouts. The caller owns the destination buffers, dstStride is in bytes and 0 means
+ * tightly packed rows. flipVertically writes the bottom row first, as Unity textures
+ * expect. All return false if the frame has no image or its format is not supported.
+ */
+extern "C" {
+    /** GRAY8, RGB24 and RGBA32 into RGBA32 (width x height) */
+    EXPORT_API bool sai_frame_convert_to_rgba32(
+        FrameWrapper* frameHandle,
+        std::uint8_t* dst,
+        int32_t dstStride,
+        bool flipVertically);
+    /** GRAY16 (e.g. depth) and GRAY8 into R16 (width x height) */
+    EXPORT_API bool sai_frame_convert_to_r16(
+        FrameWrapper* frameHandle,
+        std::uint16_t* dst,
+        int32_t dstStride,
+        bool flipVertically);
+    /** GRAY8, RGB24 and RGBA32 box-filtered into a dstWidth x dstHeight RGBA32 thumbnail */
+    EXPORT_API bool sai_frame_convert_to_rgba32_thumbnail(
+        FrameWrapper* frameHandle,
+        std::uint8_t* dst,
+        int32_t dstWidth,
+        int32_t dstHeight,
+        bool flipVertically);
+}
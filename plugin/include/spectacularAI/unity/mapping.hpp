@@ -12,6 +12,24 @@ using PointCloudWrapper = Wrapper<spectacularAI::mapping::PointCloud>;
 
 typedef void (*callback_t_mapper_output)(const MapperOutputWrapper*);
 
+/** Pixel formats of ImageViewWrapper */
+enum class ImageFormat : int32_t {
+    NONE = 0,
+    GRAY8 = 1,
+    GRAY16 = 2,
+    RGB24 = 3,
+    RGBA32 = 4
+};
+
+/** Read-only view to frame image data, valid until the FrameWrapper is released */
+struct ImageViewWrapper {
+    int32_t width;
+    int32_t height;
+    int32_t stride; // bytes per row
+    ImageFormat format;
+    const std::uint8_t* data;
+};
+
 extern "C" {
     /** MapperOutput API */
     EXPORT_API MapWrapper* sai_mapper_output_get_map(const MapperOutputWrapper* mapperOutputHandle);
@@ -45,6 +63,7 @@ extern "C" {
     /** Frame API */
     EXPORT_API spectacularAI::CameraPose* sai_frame_get_camera_pose(FrameWrapper* frameHandle);
     EXPORT_API double sai_frame_get_depth_scale(FrameWrapper* frameHandle);
+    EXPORT_API bool sai_frame_get_image(FrameWrapper* frameHandle, ImageViewWrapper* imageView);
     EXPORT_API void sai_frame_release(FrameWrapper* frameHandle);
 
     /** PointCloud API */
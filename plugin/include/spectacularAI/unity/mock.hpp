@@ -0,0 +1,62 @@
+#pragma once
+
+#include "depthai.hpp"
+
+/**
+ * Synthetic backend for the DepthAI API, selected by passing a MockBackendConfigWrapper to
+ * sai_depthai_pipeline_build. No device is opened: sessions generate VIO outputs along a
+ * scripted trajectory and, when a mapper output callback is given, keyframes with point
+ * clouds. All sai_depthai_* functions work on mock pipelines and sessions.
+ *
+ * Coordinates follow the SDK: world is z-up, the device frame is the primary camera
+ * (x right, y down, z forward) and it faces along the direction of travel.
+ */
+enum class MockTrajectory : int32_t {
+    STATIC = 0,
+    LINE = 1,
+    CIRCLE = 2,
+    FIGURE_EIGHT = 3
+};
+
+struct MockBackendConfigWrapper {
+    double outputRateHz=100.0; // capped at the configured gyroscope rate
+    bool realTime=true; // false: outputs are produced as fast as they are consumed
+    MockTrajectory trajectory=MockTrajectory::CIRCLE;
+    double speed=1.0; // m/s
+    double radius=2.0; // meters, size of CIRCLE and FIGURE_EIGHT
+    double initSeconds=0.5; // status INIT before TRACKING
+    double lostTrackingIntervalSeconds=0.0; // 0 disables LOST_TRACKING periods
+    double lostTrackingSeconds=1.0;
+    double positionNoise=0.0; // std of gaussian position noise, meters
+    double timingJitterSeconds=0.0; // max extra delivery delay per output, real time only
+    int32_t maxQueuedOutputs=1000; // real time: oldest are dropped, otherwise the generator waits
+    double keyFrameRateHz=2.0; // while tracking, needs a mapper output callback
+    int32_t pointsPerKeyFrame=2000;
+    bool pointNormals=true;
+    bool pointColors=true;
+    int32_t maxKeyFrames=0; // older keyframes are removed from the map, 0 keeps all
+    int32_t imageWidth=0; // GRAY8 primary frame images when > 0
+    int32_t imageHeight=0;
+    uint32_t seed=1;
+};
+
+struct MockSessionStatsWrapper {
+    int64_t outputs; // generated, including trigger outputs
+    int64_t triggerOutputs;
+    int64_t droppedOutputs;
+    int32_t queuedOutputs;
+    int32_t trackingStatusChanges;
+    int64_t keyFrames;
+    int64_t mapperOutputs;
+    int64_t points;
+    int64_t absolutePoses;
+    double simulatedSeconds;
+    double wallSeconds;
+};
+
+extern "C" {
+    /** Returns false if the session was not started from a mock pipeline */
+    EXPORT_API bool sai_depthai_session_get_mock_stats(
+        const spectacularAI::daiPlugin::Session* sessionHandle,
+        MockSessionStatsWrapper* stats);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <spectacularAI/replay.hpp>
+#include <spectacularAI/depthai/plugin.hpp>
+#include "types.hpp"
+#include "output.hpp"
+#include "shm.h"
+
+/**
+ * Publishes VIO outputs into a shared-memory segment (see shm.h) so that other
+ * processes can read the latest pose without their own device or replay session.
+ */
+struct PosePublisher;
+
+extern "C" {
+    /** PosePublisher API */
+    EXPORT_API PosePublisher* sai_pose_publisher_create(
+        const char* name,
+        int32_t ringCapacity,
+        char* errorMsg);
+    EXPORT_API void sai_pose_publisher_publish(
+        PosePublisher* publisherHandle,
+        const VioOutputWrapper* vioOutputHandle);
+    /**
+     * Publish every replay output. If onOutput is given, outputs are forwarded to it
+     * (and it must release them), otherwise they are released after publishing.
+     * Release the replay before the publisher.
+     */
+    EXPORT_API void sai_pose_publisher_attach_replay(
+        PosePublisher* publisherHandle,
+        spectacularAI::Replay* replayHandle,
+        callback_t_vio_output onOutput);
+    /**
+     * Publish session outputs from a background thread. Outputs are consumed from the
+     * session, use onOutput to receive them. Release the publisher before the session.
+     */
+    EXPORT_API void sai_pose_publisher_attach_session(
+        PosePublisher* publisherHandle,
+        spectacularAI::daiPlugin::Session* sessionHandle,
+        callback_t_vio_output onOutput);
+    EXPORT_API int64_t sai_pose_publisher_get_published_count(PosePublisher* publisherHandle);
+    EXPORT_API void sai_pose_publisher_release(PosePublisher* publisherHandle);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "types.hpp"
+#include "mapping.hpp"
+
+/**
+ * Prepares render-ready keyframe point cloud buffers on worker threads. Mapper outputs
+ * are pushed in, finished items are pulled out on the main thread a few at a time so
+ * that large map updates do not stall a single frame.
+ */
+struct RenderQueue;
+struct RenderItem;
+
+/**
+ * Render-ready buffers of one keyframe. Positions and normals are in the keyframe's
+ * camera coordinates converted to Unity's camera convention (y flipped), colors are RGBA32.
+ * Buffers are valid until the item is released.
+ */
+struct RenderItemWrapper {
+    int64_t keyFrameId;
+    bool removed; // keyframe was deleted from the map
+    bool hasGeometry; // false when only the pose changed
+    spectacularAI::Pose pose; // keyframe camera->world
+    int32_t vertexCount;
+    const float* positions; // 3 * vertexCount
+    const float* normals; // 3 * vertexCount, null if the point cloud has no normals
+    const std::uint8_t* colors; // 4 * vertexCount, null if the point cloud has no colors
+    const std::uint32_t* indices; // vertexCount
+    int64_t bytes; // total size of the buffers
+    double preparationMs;
+};
+
+struct RenderQueueStatsWrapper {
+    int32_t pendingJobs; // waiting for or being prepared by workers
+    int32_t readyItems;
+    int64_t readyBytes;
+    int64_t preparedItems;
+    int64_t staleItems; // superseded by a newer update before being pulled
+    double meanPreparationMs;
+    double maxPreparationMs;
+};
+
+extern "C" {
+    /** RenderQueue API */
+    EXPORT_API RenderQueue* sai_render_queue_create(int32_t threadCount);
+    EXPORT_API void sai_render_queue_push(
+        RenderQueue* renderQueueHandle,
+        const MapperOutputWrapper* mapperOutputHandle);
+    /** Returns null if no item is ready */
+    EXPORT_API RenderItem* sai_render_queue_try_pop(RenderQueue* renderQueueHandle);
+    EXPORT_API RenderQueueStatsWrapper sai_render_queue_get_stats(RenderQueue* renderQueueHandle);
+    EXPORT_API void sai_render_queue_release(RenderQueue* renderQueueHandle);
+
+    /** RenderItem API */
+    EXPORT_API void sai_render_item_get(const RenderItem* renderItemHandle, RenderItemWrapper* renderItem);
+    EXPORT_API void sai_render_item_release(RenderItem* renderItemHandle);
+}
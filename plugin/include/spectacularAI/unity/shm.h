@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * Shared-memory pose stream. One writer process publishes VIO poses into a POSIX
+ * shared-memory segment and any number of reader processes map it read-only.
+ *
+ * The segment holds a seqlock protected "latest pose" slot and a ring of recent
+ * snapshots. Readers never block the writer and make no syscalls after opening:
+ * a read is a few atomic loads and a copy out of the mapped memory. A reader that
+ * falls more than the ring capacity behind skips the overwritten snapshots.
+ *
+ * Plain C so that it can be used without the rest of the plugin.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAI_SHM_MAGIC 0x50494153u /* "SAIP" */
+#define SAI_SHM_VERSION 1u
+
+/** Pose snapshot, world coordinates as in spectacularAI::VioOutput */
+typedef struct {
+    uint64_t sequence; /* index of the snapshot, starts from 0 */
+    double time; /* VIO timestamp, seconds */
+    double publishTime; /* CLOCK_MONOTONIC of the writer when published, seconds */
+    double position[3];
+    double orientation[4]; /* x, y, z, w */
+    double velocity[3];
+    double angularVelocity[3];
+    int32_t trackingStatus;
+    int32_t tag;
+} sai_shm_pose;
+
+typedef struct sai_shm_writer sai_shm_writer;
+typedef struct sai_shm_reader sai_shm_reader;
+
+/**
+ * Create (or replace) segment `name` (e.g. "/sai_pose") with room for `ringCapacity`
+ * snapshots. Returns NULL on failure, `errorMsg` (if given, 1000 chars) describes why.
+ */
+sai_shm_writer* sai_shm_writer_create(const char* name, uint32_t ringCapacity, char* errorMsg);
+/** Publish a snapshot. `pose->sequence` is assigned by the writer. Single writer only. */
+void sai_shm_writer_publish(sai_shm_writer* writer, const sai_shm_pose* pose);
+/** Unmaps and unlinks the segment, readers that still have it open keep working */
+void sai_shm_writer_close(sai_shm_writer* writer);
+
+/** Open an existing segment. Returns NULL if it does not exist or is incompatible. */
+sai_shm_reader* sai_shm_reader_open(const char* name);
+/**
+ * Copy the latest pose. Returns 1 on success, 0 if nothing has been published yet or the
+ * writer did not finish its update in time (e.g. it died while publishing).
+ */
+int sai_shm_reader_latest(sai_shm_reader* reader, sai_shm_pose* pose);
+/**
+ * Copy the next unread ring snapshot. Returns 1 on success, 0 if there is no new one
+ * or it is still being written (never blocks on a stalled writer).
+ * `dropped` (optional) is incremented by the number of snapshots that were overwritten
+ * before this reader got to them.
+ */
+int sai_shm_reader_next(sai_shm_reader* reader, sai_shm_pose* pose, uint64_t* dropped);
+/** Total number of snapshots published so far */
+uint64_t sai_shm_reader_published_count(sai_shm_reader* reader);
+void sai_shm_reader_close(sai_shm_reader* reader);
+
+#ifdef __cplusplus
+}
+#endif
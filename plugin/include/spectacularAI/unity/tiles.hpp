@@ -0,0 +1,95 @@
+#pragma once
+
+#include "types.hpp"
+#include "mapping.hpp"
+#include "output.hpp"
+
+/**
+ * Spatially tiled, out-of-core store for large maps. Keyframe poses and their world
+ * frame points are bucketed into square tiles on the horizontal (x-y) plane of the
+ * SDK world. Tiles near the camera are kept in memory, the rest are paged out to a
+ * local page file by a worker thread. Mapper outputs can be released right after
+ * they have been ingested, the store keeps only poses, points and colors.
+ */
+struct TileStore;
+
+struct TileStoreConfigWrapper {
+    const char* pageFilePath=""; // created or truncated, removed on release
+    double tileSize=10.0; // meters
+    double activeRadius=20.0; // tiles within this distance (meters) of the camera are always resident
+    double prefetchSeconds=3.0; // also page in tiles along the velocity this far ahead
+    int64_t memoryCapBytes=256 * 1024 * 1024; // resident point data, active tiles may exceed it
+    bool compactPoints=true; // store points quantised as in compact.hpp, 8 instead of 15 bytes per point
+};
+
+struct TileInfoWrapper {
+    int32_t x; // tile index, covers [x, x + 1) * tileSize in world x
+    int32_t y;
+    bool resident;
+    bool dirty; // resident copy differs from the page file
+    int32_t keyFrameCount;
+    int32_t pointCount;
+    int64_t bytes; // size in memory when resident
+};
+
+struct TileStoreStatsWrapper {
+    int32_t tiles;
+    int32_t residentTiles;
+    int32_t dirtyTiles;
+    int32_t pendingJobs;
+    int64_t keyFrames;
+    int64_t points;
+    int64_t residentBytes;
+    int64_t memoryCapBytes;
+    int64_t loads;
+    int64_t prefetchLoads; // loaded ahead of the camera
+    int64_t prefetchHits; // prefetched tiles that reached the active radius while resident
+    int64_t activeMisses; // tiles loaded only after they were already within the active radius
+    int64_t demandLoads; // loaded to apply a keyframe update to a paged out tile
+    int64_t evictions;
+    int64_t failedUpdates; // keyframe updates and removals dropped because a tile could not be read back
+    int64_t writes;
+    int64_t bytesRead;
+    int64_t bytesWritten;
+    int64_t pageFileBytes;
+    int64_t pageFileDeadBytes; // in abandoned slots waiting to be reused
+    double meanLoadMs;
+    double maxLoadMs;
+};
+
+extern "C" {
+    /** Returns null on failure, `errorMsg` (1000 chars) describes why */
+    EXPORT_API TileStore* sai_tile_store_create(const TileStoreConfigWrapper* config, char* errorMsg);
+    /** Queue the updated and removed keyframes of the mapper output, applied asynchronously */
+    EXPORT_API void sai_tile_store_ingest(TileStore* tileStoreHandle, const MapperOutputWrapper* mapperOutputHandle);
+    /** Page tiles in and out around the camera position, prefetching along the velocity */
+    EXPORT_API void sai_tile_store_update_position(TileStore* tileStoreHandle, const VioOutputWrapper* vioOutputHandle);
+    /** Block until queued work is done and all dirty tiles have been written to the page file */
+    EXPORT_API void sai_tile_store_flush(TileStore* tileStoreHandle);
+    /**
+     * Write all points (resident or not) as a binary PLY in SDK world coordinates with RGB colors.
+     * Returns false on failure, `errorMsg` (1000 chars) describes why.
+     */
+    EXPORT_API bool sai_tile_store_export_ply(TileStore* tileStoreHandle, const char* path, char* errorMsg);
+    /** Returns the number of tiles, the array is valid until the next call */
+    EXPORT_API int32_t sai_tile_store_get_tiles(TileStore* tileStoreHandle, const TileInfoWrapper** tilesHandle);
+    /**
+     * Copy the points of a resident tile, positions in Unity world coordinates (3 floats per point)
+     * and RGBA32 colors (may be null). Copies at most `capacity` points. Returns the number of
+     * points in the tile, or -1 if the tile does not exist or is not resident.
+     */
+    EXPORT_API int32_t sai_tile_store_copy_tile_points(
+        TileStore* tileStoreHandle,
+        int32_t tileX,
+        int32_t tileY,
+        float* positions,
+        std::uint8_t* colors,
+        int32_t capacity);
+    /** Latest camera->world pose of an ingested keyframe, resident or not */
+    EXPORT_API bool sai_tile_store_get_key_frame_pose(
+        TileStore* tileStoreHandle,
+        int64_t keyFrameId,
+        spectacularAI::Pose* pose);
+    EXPORT_API TileStoreStatsWrapper sai_tile_store_get_stats(TileStore* tileStoreHandle);
+    EXPORT_API void sai_tile_store_release(TileStore* tileStoreHandle);
+}
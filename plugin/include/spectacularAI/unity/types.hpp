@@ -7,12 +7,32 @@
     #define EXPORT_API __attribute__((visibility("default")))
 #endif
 
+/** Marks helpers shared between the plugin's own translation units, never exported */
+#ifdef _MSC_VER
+    #define INTERNAL_API
+#else
+    #define INTERNAL_API __attribute__((visibility("hidden")))
+#endif
+
+#include <atomic>
 #include <spectacularAI/types.hpp>
 
+// Number of live handles per type, for leak diagnostics
+template<typename T>
+struct HandleCounter {
+    static std::atomic<int64_t> live;
+};
+
+template<typename T>
+std::atomic<int64_t> HandleCounter<T>::live(0);
+
 // Keeps std::shared_ptr alive
 template<typename T>
 struct Wrapper {
-    Wrapper(std::shared_ptr<T> handle) : _handle(handle) {}
+    Wrapper(std::shared_ptr<T> handle) : _handle(handle) { ++HandleCounter<T>::live; }
+    Wrapper(const Wrapper&) = delete;
+    Wrapper& operator=(const Wrapper&) = delete;
+    ~Wrapper() { --HandleCounter<T>::live; }
     std::shared_ptr<T> getHandle() const { return _handle; }
 
 private:
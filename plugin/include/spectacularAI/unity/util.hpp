@@ -1,11 +1,32 @@
 #pragma once
 
 #include "types.hpp"
+#include "output.hpp"
+#include "mapping.hpp"
+
+/** Number of live (unreleased) handles returned by the API, per type */
+struct HandleCountsWrapper {
+    int64_t vioOutputs;
+    int64_t cameraPoses;
+    int64_t cameras;
+    int64_t mapperOutputs;
+    int64_t maps;
+    int64_t keyFrames;
+    int64_t frameSets;
+    int64_t frames;
+    int64_t pointClouds;
+};
 
 Matrix3dWrapper matrix_to_wrapper(const spectacularAI::Matrix3d &m);
 Matrix4dWrapper matrix_to_wrapper(const spectacularAI::Matrix4d &m);
 
+/** Rigid transform helpers, matrices are homogeneous local->world (or a->b) transforms */
+spectacularAI::Matrix4d matrix_multiply(const spectacularAI::Matrix4d &a, const spectacularAI::Matrix4d &b);
+spectacularAI::Matrix4d matrix_rigid_inverse(const spectacularAI::Matrix4d &m);
+spectacularAI::Vector3d matrix_transform_point(const spectacularAI::Matrix4d &m, const spectacularAI::Vector3d &p);
+
 extern "C" {
     EXPORT_API Matrix4dWrapper sai_pose_as_matrix(spectacularAI::Vector3d position, spectacularAI::Quaternion orientation);
     EXPORT_API spectacularAI::Pose sai_pose_from_matrix(double t, Matrix4dWrapper localToWorld);
+    EXPORT_API HandleCountsWrapper sai_get_live_handle_counts();
 }
\ No newline at end of file
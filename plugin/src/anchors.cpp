@@ -0,0 +1,306 @@
+#include "../include/spectacularAI/unity/anchors.hpp"
+#include "../include/spectacularAI/unity/util.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct Attachment {
+    int64_t keyFrameId;
+    spectacularAI::Matrix4d anchorToKeyFrame;
+    double weight;
+};
+
+struct Anchor {
+    double time;
+    spectacularAI::Matrix4d anchorToWorld;
+    std::vector<Attachment> attachments;
+};
+
+bool get_key_frame_to_world(const spectacularAI::mapping::KeyFrame &keyFrame, spectacularAI::Matrix4d &keyFrameToWorld) {
+    if (!keyFrame.frameSet || !keyFrame.frameSet->primaryFrame) return false;
+    keyFrameToWorld = keyFrame.frameSet->primaryFrame->cameraPose.getCameraToWorldMatrix();
+    return true;
+}
+
+double distance(const spectacularAI::Matrix4d &a, const spectacularAI::Matrix4d &b) {
+    double dx = a[0][3] - b[0][3];
+    double dy = a[1][3] - b[1][3];
+    double dz = a[2][3] - b[2][3];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+double rotation_angle(const spectacularAI::Matrix4d &a, const spectacularAI::Matrix4d &b) {
+    // trace(A^T B) = 1 + 2 cos(angle)
+    double trace = 0;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) trace += a[j][i] * b[j][i];
+    }
+    double c = std::max(-1.0, std::min(1.0, (trace - 1.0) * 0.5));
+    return std::acos(c);
+}
+
+} // anonymous namespace
+
+struct AnchorSet {
+    AnchorSet(int keyFramesPerAnchor, double minPositionChange, double minAngleChange) :
+        keyFramesPerAnchor(std::max(1, keyFramesPerAnchor)),
+        minPositionChange(minPositionChange),
+        minAngleChange(minAngleChange) {}
+
+    int64_t add(const spectacularAI::mapping::Map *map, const spectacularAI::Pose &anchorToWorld) {
+        std::lock_guard<std::mutex> lock(mutex);
+        int64_t id = nextId++;
+        Anchor &anchor = anchors[id];
+        anchor.time = anchorToWorld.time;
+        anchor.anchorToWorld = anchorToWorld.asMatrix();
+        if (!map || !attach(id, anchor, *map)) orphans.insert(id);
+        return id;
+    }
+
+    bool remove(int64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = anchors.find(id);
+        if (it == anchors.end()) return false;
+        detach(id, it->second);
+        orphans.erase(id);
+        anchors.erase(it);
+        return true;
+    }
+
+    bool getPose(int64_t id, spectacularAI::Pose &anchorToWorld) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = anchors.find(id);
+        if (it == anchors.end()) return false;
+        anchorToWorld = spectacularAI::Pose::fromMatrix(it->second.time, it->second.anchorToWorld);
+        return true;
+    }
+
+    int32_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (int32_t)anchors.size();
+    }
+
+    /**
+     * Recomputes the anchors attached to the updated keyframes. Cost is proportional to
+     * the number of affected anchors, not the total number of anchors or keyframes.
+     */
+    const std::vector<AnchorUpdateWrapper> &update(const spectacularAI::mapping::MapperOutput &output) {
+        std::lock_guard<std::mutex> lock(mutex);
+        updates.clear();
+        if (!output.map) return updates;
+        const spectacularAI::mapping::Map &map = *output.map;
+
+        dirty.clear();
+        for (int64_t keyFrameId : output.updatedKeyFrames) {
+            auto it = keyFrameAnchors.find(keyFrameId);
+            if (it == keyFrameAnchors.end()) continue;
+            dirty.insert(dirty.end(), it->second.begin(), it->second.end());
+        }
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+        for (int64_t id : dirty) {
+            Anchor &anchor = anchors.at(id);
+            spectacularAI::Matrix4d anchorToWorld;
+            if (!recompute(id, anchor, map, anchorToWorld)) {
+                // All keyframes were removed, keep the last pose and re-attach
+                if (!attach(id, anchor, map)) orphans.insert(id);
+                continue;
+            }
+
+            bool moved = distance(anchor.anchorToWorld, anchorToWorld) > minPositionChange
+                || rotation_angle(anchor.anchorToWorld, anchorToWorld) > minAngleChange;
+            if (!moved) continue;
+
+            anchor.anchorToWorld = anchorToWorld;
+            updates.push_back(AnchorUpdateWrapper {
+                id,
+                spectacularAI::Pose::fromMatrix(anchor.time, anchorToWorld)
+            });
+        }
+
+        // Orphans had no usable keyframe when they were last attached, so only the
+        // updated (including newly added) keyframes can be new candidates
+        if (!orphans.empty() && !output.updatedKeyFrames.empty()) {
+            for (auto it = orphans.begin(); it != orphans.end();) {
+                if (attach(*it, anchors.at(*it), map, &output.updatedKeyFrames)) it = orphans.erase(it);
+                else ++it;
+            }
+        }
+
+        return updates;
+    }
+
+private:
+    const int keyFramesPerAnchor;
+    const double minPositionChange;
+    const double minAngleChange;
+
+    std::mutex mutex;
+    int64_t nextId = 0;
+    std::unordered_map<int64_t, Anchor> anchors;
+    std::unordered_map<int64_t, std::vector<int64_t>> keyFrameAnchors;
+    std::unordered_set<int64_t> orphans;
+    std::vector<int64_t> dirty;
+    std::vector<AnchorUpdateWrapper> updates;
+
+    /**
+     * Attach to the nearest keyframes. Considers all keyframes of the map, O(keyframes), or
+     * only those listed in `keyFrameIds` when it is given.
+     */
+    bool attach(
+            int64_t id,
+            Anchor &anchor,
+            const spectacularAI::mapping::Map &map,
+            const std::vector<int64_t> *keyFrameIds = nullptr) {
+        struct Candidate {
+            double distance;
+            int64_t keyFrameId;
+            spectacularAI::Matrix4d keyFrameToWorld;
+        };
+        std::vector<Candidate> candidates;
+        auto consider = [&](int64_t keyFrameId, const std::shared_ptr<const spectacularAI::mapping::KeyFrame> &keyFrame) {
+            spectacularAI::Matrix4d keyFrameToWorld;
+            if (!keyFrame || !get_key_frame_to_world(*keyFrame, keyFrameToWorld)) return;
+            candidates.push_back(Candidate { distance(keyFrameToWorld, anchor.anchorToWorld), keyFrameId, keyFrameToWorld });
+        };
+        if (keyFrameIds) {
+            candidates.reserve(keyFrameIds->size());
+            for (int64_t keyFrameId : *keyFrameIds) {
+                auto it = map.keyFrames.find(keyFrameId);
+                if (it != map.keyFrames.end()) consider(it->first, it->second);
+            }
+        } else {
+            candidates.reserve(map.keyFrames.size());
+            for (const auto &it : map.keyFrames) consider(it.first, it.second);
+        }
+        if (candidates.empty()) return false;
+
+        size_t n = std::min(candidates.size(), (size_t)keyFramesPerAnchor);
+        std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end(),
+            [](const Candidate &a, const Candidate &b) { return a.distance < b.distance; });
+
+        anchor.attachments.clear();
+        for (size_t i = 0; i < n; ++i) {
+            const Candidate &c = candidates[i];
+            anchor.attachments.push_back(Attachment {
+                c.keyFrameId,
+                matrix_multiply(matrix_rigid_inverse(c.keyFrameToWorld), anchor.anchorToWorld),
+                1.0 / std::max(c.distance, 1e-3)
+            });
+            keyFrameAnchors[c.keyFrameId].push_back(id);
+        }
+        return true;
+    }
+
+    void detach(int64_t id, Anchor &anchor) {
+        for (const Attachment &a : anchor.attachments) {
+            auto it = keyFrameAnchors.find(a.keyFrameId);
+            if (it == keyFrameAnchors.end()) continue;
+            std::vector<int64_t> &ids = it->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+            if (ids.empty()) keyFrameAnchors.erase(it);
+        }
+        anchor.attachments.clear();
+    }
+
+    /**
+     * Position is the weighted mean of the positions predicted by each attached keyframe,
+     * orientation is taken from the closest surviving keyframe. Attachments to deleted
+     * keyframes are dropped.
+     */
+    bool recompute(int64_t id, Anchor &anchor, const spectacularAI::mapping::Map &map, spectacularAI::Matrix4d &anchorToWorld) {
+        double weightSum = 0;
+        double bestWeight = -1;
+        spectacularAI::Vector3d position { 0, 0, 0 };
+
+        for (size_t i = 0; i < anchor.attachments.size();) {
+            const Attachment &a = anchor.attachments[i];
+            auto it = map.keyFrames.find(a.keyFrameId);
+            spectacularAI::Matrix4d keyFrameToWorld;
+            if (it == map.keyFrames.end() || !it->second || !get_key_frame_to_world(*it->second, keyFrameToWorld)) {
+                auto index = keyFrameAnchors.find(a.keyFrameId);
+                if (index != keyFrameAnchors.end()) {
+                    std::vector<int64_t> &ids = index->second;
+                    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+                    if (ids.empty()) keyFrameAnchors.erase(index);
+                }
+                anchor.attachments.erase(anchor.attachments.begin() + i);
+                continue;
+            }
+
+            spectacularAI::Matrix4d predicted = matrix_multiply(keyFrameToWorld, a.anchorToKeyFrame);
+            position.x += a.weight * predicted[0][3];
+            position.y += a.weight * predicted[1][3];
+            position.z += a.weight * predicted[2][3];
+            weightSum += a.weight;
+            if (a.weight > bestWeight) {
+                bestWeight = a.weight;
+                anchorToWorld = predicted;
+            }
+            ++i;
+        }
+
+        if (weightSum <= 0) return false;
+        anchorToWorld[0][3] = position.x / weightSum;
+        anchorToWorld[1][3] = position.y / weightSum;
+        anchorToWorld[2][3] = position.z / weightSum;
+        return true;
+    }
+};
+
+AnchorSet* sai_anchor_set_create(
+        int32_t keyFramesPerAnchor,
+        double minPositionChange,
+        double minAngleChange) {
+    return new AnchorSet(keyFramesPerAnchor, minPositionChange, minAngleChange);
+}
+
+int64_t sai_anchor_set_add(
+        AnchorSet* anchorSetHandle,
+        const MapWrapper* mapHandle,
+        spectacularAI::Pose anchorToWorld) {
+    assert(anchorSetHandle);
+    return anchorSetHandle->add(mapHandle ? mapHandle->getHandle().get() : nullptr, anchorToWorld);
+}
+
+bool sai_anchor_set_remove(AnchorSet* anchorSetHandle, int64_t anchorId) {
+    assert(anchorSetHandle);
+    return anchorSetHandle->remove(anchorId);
+}
+
+bool sai_anchor_set_get_pose(
+        AnchorSet* anchorSetHandle,
+        int64_t anchorId,
+        spectacularAI::Pose* anchorToWorld) {
+    assert(anchorSetHandle);
+    assert(anchorToWorld);
+    return anchorSetHandle->getPose(anchorId, *anchorToWorld);
+}
+
+int32_t sai_anchor_set_get_count(AnchorSet* anchorSetHandle) {
+    assert(anchorSetHandle);
+    return anchorSetHandle->count();
+}
+
+int32_t sai_anchor_set_update(
+        AnchorSet* anchorSetHandle,
+        const MapperOutputWrapper* mapperOutputHandle,
+        const AnchorUpdateWrapper** updatedAnchorsHandle) {
+    assert(anchorSetHandle);
+    assert(mapperOutputHandle);
+    const std::vector<AnchorUpdateWrapper> &updates = anchorSetHandle->update(*mapperOutputHandle->getHandle());
+    *updatedAnchorsHandle = updates.data();
+    return (int32_t)updates.size();
+}
+
+void sai_anchor_set_release(AnchorSet* anchorSetHandle) {
+    if (anchorSetHandle) delete anchorSetHandle;
+}
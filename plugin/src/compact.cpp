@@ -0,0 +1,453 @@
+#include "../include/spectacularAI/unity/compact.hpp"
+#include "compact_points.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SAI_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SAI_SSE2
+    #if defined(__SSSE3__) || defined(__AVX__)
+        #include <tmmintrin.h>
+        #define SAI_SSSE3
+    #endif
+#endif
+
+namespace {
+
+const float MAX_QUANTIZED = 65535.0f;
+
+inline float sign_not_zero(float v) {
+    return v < 0.0f ? -1.0f : 1.0f;
+}
+
+inline std::uint16_t rgb565(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    // Rounded r * 31 / 255 and g * 63 / 255 without divisions
+    return (std::uint16_t)((((r * 249 + 1014) >> 11) << 11) | (((g * 253 + 505) >> 10) << 5) | ((b * 249 + 1014) >> 11));
+}
+
+#if defined(SAI_SSE2)
+// Unsigned saturating 32 -> 16 bit pack, _mm_packus_epi32 needs SSE4.1
+inline __m128i pack_u16(__m128i a, __m128i b) {
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32)), bias16);
+}
+#endif
+
+} // anonymous namespace
+
+namespace saiInternal {
+
+QuantizationBox quantization_box(const float* positions, size_t n) {
+    QuantizationBox box;
+    for (int c = 0; c < 3; ++c) {
+        float lo = std::numeric_limits<float>::max();
+        float hi = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < n; ++i) {
+            lo = std::min(lo, positions[3 * i + c]);
+            hi = std::max(hi, positions[3 * i + c]);
+        }
+        if (n == 0) lo = hi = 0.0f;
+        box.offset[c] = lo;
+        box.scale[c] = (hi - lo) / MAX_QUANTIZED;
+    }
+    return box;
+}
+
+void encode_positions(const float* src, size_t n, const QuantizationBox &box, std::uint16_t* dst) {
+    float inv[3];
+    for (int c = 0; c < 3; ++c) inv[c] = box.scale[c] > 0.0f ? 1.0f / box.scale[c] : 0.0f;
+    size_t i = 0;
+    // 4 points (12 floats) per iteration, the xyz pattern repeats every 3 vectors
+#if defined(SAI_NEON)
+    const float o[12] = { box.offset[0], box.offset[1], box.offset[2], box.offset[0], box.offset[1], box.offset[2],
+        box.offset[0], box.offset[1], box.offset[2], box.offset[0], box.offset[1], box.offset[2] };
+    const float s[12] = { inv[0], inv[1], inv[2], inv[0], inv[1], inv[2], inv[0], inv[1], inv[2], inv[0], inv[1], inv[2] };
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t top = vdupq_n_f32(MAX_QUANTIZED);
+    float32x4_t off[3], mul[3];
+    for (int k = 0; k < 3; ++k) {
+        off[k] = vld1q_f32(o + 4 * k);
+        mul[k] = vld1q_f32(s + 4 * k);
+    }
+    for (; i + 4 <= n; i += 4) {
+        uint16x4_t q[3];
+        for (int k = 0; k < 3; ++k) {
+            float32x4_t v = vmulq_f32(vsubq_f32(vld1q_f32(src + 3 * i + 4 * k), off[k]), mul[k]);
+            v = vminq_f32(vmaxq_f32(v, zero), top);
+            q[k] = vmovn_u32(vcvtq_u32_f32(vaddq_f32(v, half)));
+        }
+        vst1q_u16(dst + 3 * i, vcombine_u16(q[0], q[1]));
+        vst1_u16(dst + 3 * i + 8, q[2]);
+    }
+#elif defined(SAI_SSE2)
+    const __m128 off0 = _mm_setr_ps(box.offset[0], box.offset[1], box.offset[2], box.offset[0]);
+    const __m128 off1 = _mm_setr_ps(box.offset[1], box.offset[2], box.offset[0], box.offset[1]);
+    const __m128 off2 = _mm_setr_ps(box.offset[2], box.offset[0], box.offset[1], box.offset[2]);
+    const __m128 mul0 = _mm_setr_ps(inv[0], inv[1], inv[2], inv[0]);
+    const __m128 mul1 = _mm_setr_ps(inv[1], inv[2], inv[0], inv[1]);
+    const __m128 mul2 = _mm_setr_ps(inv[2], inv[0], inv[1], inv[2]);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 top = _mm_set1_ps(MAX_QUANTIZED);
+    for (; i + 4 <= n; i += 4) {
+        const float* p = src + 3 * i;
+        __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + 0), off0), mul0), zero), top));
+        __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + 4), off1), mul1), zero), top));
+        __m128i c = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + 8), off2), mul2), zero), top));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * i), pack_u16(a, b));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 3 * i + 8), pack_u16(c, c));
+    }
+#endif
+    for (; i < n; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            float v = (src[3 * i + c] - box.offset[c]) * inv[c];
+            v = std::min(std::max(v, 0.0f), MAX_QUANTIZED);
+            dst[3 * i + c] = (std::uint16_t)std::lrint(v);
+        }
+    }
+}
+
+void decode_positions(const std::uint16_t* src, size_t n, const QuantizationBox &box, float* dst) {
+    size_t i = 0;
+#if defined(SAI_NEON)
+    const float o[12] = { box.offset[0], box.offset[1], box.offset[2], box.offset[0], box.offset[1], box.offset[2],
+        box.offset[0], box.offset[1], box.offset[2], box.offset[0], box.offset[1], box.offset[2] };
+    const float s[12] = { box.scale[0], box.scale[1], box.scale[2], box.scale[0], box.scale[1], box.scale[2],
+        box.scale[0], box.scale[1], box.scale[2], box.scale[0], box.scale[1], box.scale[2] };
+    float32x4_t off[3], mul[3];
+    for (int k = 0; k < 3; ++k) {
+        off[k] = vld1q_f32(o + 4 * k);
+        mul[k] = vld1q_f32(s + 4 * k);
+    }
+    for (; i + 4 <= n; i += 4) {
+        uint16x8_t ab = vld1q_u16(src + 3 * i);
+        uint16x4_t c = vld1_u16(src + 3 * i + 8);
+        uint32x4_t q[3] = { vmovl_u16(vget_low_u16(ab)), vmovl_u16(vget_high_u16(ab)), vmovl_u16(c) };
+        for (int k = 0; k < 3; ++k) {
+            vst1q_f32(dst + 3 * i + 4 * k, vmlaq_f32(off[k], vcvtq_f32_u32(q[k]), mul[k]));
+        }
+    }
+#elif defined(SAI_SSE2)
+    const __m128 off0 = _mm_setr_ps(box.offset[0], box.offset[1], box.offset[2], box.offset[0]);
+    const __m128 off1 = _mm_setr_ps(box.offset[1], box.offset[2], box.offset[0], box.offset[1]);
+    const __m128 off2 = _mm_setr_ps(box.offset[2], box.offset[0], box.offset[1], box.offset[2]);
+    const __m128 mul0 = _mm_setr_ps(box.scale[0], box.scale[1], box.scale[2], box.scale[0]);
+    const __m128 mul1 = _mm_setr_ps(box.scale[1], box.scale[2], box.scale[0], box.scale[1]);
+    const __m128 mul2 = _mm_setr_ps(box.scale[2], box.scale[0], box.scale[1], box.scale[2]);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i ab = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+        __m128i c = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 3 * i + 8));
+        float* p = dst + 3 * i;
+        _mm_storeu_ps(p + 0, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(ab, zero)), mul0), off0));
+        _mm_storeu_ps(p + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(ab, zero)), mul1), off1));
+        _mm_storeu_ps(p + 8, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(c, zero)), mul2), off2));
+    }
+#endif
+    for (; i < n; ++i) {
+        for (int c = 0; c < 3; ++c) dst[3 * i + c] = src[3 * i + c] * box.scale[c] + box.offset[c];
+    }
+}
+
+void encode_normals_oct(const float* src, size_t n, int bytesPerNormal, std::uint8_t* dst) {
+    assert(bytesPerNormal == 2 || bytesPerNormal == 4);
+    const float range = bytesPerNormal == 4 ? 32767.0f : 127.0f;
+    size_t i = 0;
+#if defined(SAI_SSE2)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 tiny = _mm_set1_ps(1e-20f);
+    const __m128 scale = _mm_set1_ps(range);
+    for (; i + 4 <= n; i += 4) {
+        const float* p = src + 3 * i;
+        __m128 x = _mm_setr_ps(p[0], p[3], p[6], p[9]);
+        __m128 y = _mm_setr_ps(p[1], p[4], p[7], p[10]);
+        __m128 z = _mm_setr_ps(p[2], p[5], p[8], p[11]);
+        __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+        __m128 inv = _mm_div_ps(one, _mm_max_ps(l1, tiny));
+        x = _mm_mul_ps(x, inv);
+        y = _mm_mul_ps(y, inv);
+        // Fold the lower hemisphere over the diagonals
+        __m128 lower = _mm_cmplt_ps(z, zero);
+        __m128 fx = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, y)), _mm_or_ps(_mm_and_ps(x, signMask), one));
+        __m128 fy = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_or_ps(_mm_and_ps(y, signMask), one));
+        x = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, x));
+        y = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, y));
+        __m128i qx = _mm_cvtps_epi32(_mm_mul_ps(x, scale));
+        __m128i qy = _mm_cvtps_epi32(_mm_mul_ps(y, scale));
+        if (bytesPerNormal == 4) {
+            __m128i w = _mm_or_si128(_mm_and_si128(qx, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(qy, 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), w);
+        } else {
+            const __m128i low = _mm_set1_epi32(0xFF);
+            __m128i w = _mm_or_si128(_mm_and_si128(qx, low), _mm_slli_epi32(_mm_and_si128(qy, low), 8));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 2 * i), pack_u16(w, w));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        float x = src[3 * i + 0];
+        float y = src[3 * i + 1];
+        const float z = src[3 * i + 2];
+        const float inv = 1.0f / std::max(std::abs(x) + std::abs(y) + std::abs(z), 1e-20f);
+        x *= inv;
+        y *= inv;
+        if (z < 0.0f) {
+            const float fx = (1.0f - std::abs(y)) * sign_not_zero(x);
+            const float fy = (1.0f - std::abs(x)) * sign_not_zero(y);
+            x = fx;
+            y = fy;
+        }
+        const long qx = std::lrint(x * range);
+        const long qy = std::lrint(y * range);
+        if (bytesPerNormal == 4) {
+            const std::int16_t q[2] = { (std::int16_t)qx, (std::int16_t)qy };
+            std::memcpy(dst + 4 * i, q, sizeof(q));
+        } else {
+            dst[2 * i + 0] = (std::uint8_t)(std::int8_t)qx;
+            dst[2 * i + 1] = (std::uint8_t)(std::int8_t)qy;
+        }
+    }
+}
+
+void decode_normals_oct(const std::uint8_t* src, size_t n, int bytesPerNormal, float* dst) {
+    assert(bytesPerNormal == 2 || bytesPerNormal == 4);
+    const float invRange = bytesPerNormal == 4 ? 1.0f / 32767.0f : 1.0f / 127.0f;
+    size_t i = 0;
+#if defined(SAI_SSE2)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 scale = _mm_set1_ps(invRange);
+    for (; i + 4 <= n; i += 4) {
+        __m128i qx, qy;
+        if (bytesPerNormal == 4) {
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+            qx = _mm_srai_epi32(_mm_slli_epi32(w, 16), 16);
+            qy = _mm_srai_epi32(w, 16);
+        } else {
+            __m128i w = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 2 * i)), _mm_setzero_si128());
+            qx = _mm_srai_epi32(_mm_slli_epi32(w, 24), 24);
+            qy = _mm_srai_epi32(_mm_slli_epi32(w, 16), 24);
+        }
+        __m128 x = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(qx), scale), minusOne);
+        __m128 y = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(qy), scale), minusOne);
+        __m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_andnot_ps(signMask, y));
+        // Unfold the lower hemisphere: move x and y towards the diagonal by max(-z, 0)
+        __m128 t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+        x = _mm_sub_ps(x, _mm_or_ps(t, _mm_and_ps(x, signMask)));
+        y = _mm_sub_ps(y, _mm_or_ps(t, _mm_and_ps(y, signMask)));
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))));
+        float xs[4], ys[4], zs[4];
+        _mm_storeu_ps(xs, _mm_mul_ps(x, inv));
+        _mm_storeu_ps(ys, _mm_mul_ps(y, inv));
+        _mm_storeu_ps(zs, _mm_mul_ps(z, inv));
+        float* p = dst + 3 * i;
+        for (int k = 0; k < 4; ++k) {
+            p[3 * k + 0] = xs[k];
+            p[3 * k + 1] = ys[k];
+            p[3 * k + 2] = zs[k];
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        float x, y;
+        if (bytesPerNormal == 4) {
+            std::int16_t q[2];
+            std::memcpy(q, src + 4 * i, sizeof(q));
+            x = q[0] * invRange;
+            y = q[1] * invRange;
+        } else {
+            x = (std::int8_t)src[2 * i + 0] * invRange;
+            y = (std::int8_t)src[2 * i + 1] * invRange;
+        }
+        x = std::max(x, -1.0f);
+        y = std::max(y, -1.0f);
+        const float z = 1.0f - std::abs(x) - std::abs(y);
+        const float t = std::max(-z, 0.0f);
+        x -= std::copysign(t, x);
+        y -= std::copysign(t, y);
+        const float inv = 1.0f / std::sqrt(x * x + y * y + z * z);
+        dst[3 * i + 0] = x * inv;
+        dst[3 * i + 1] = y * inv;
+        dst[3 * i + 2] = z * inv;
+    }
+}
+
+void encode_rgb565(const std::uint8_t* rgb, size_t n, std::uint16_t* dst) {
+    size_t i = 0;
+#if defined(SAI_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint8x8x3_t c = vld3_u8(rgb + 3 * i);
+        uint16x8_t r = vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(1014), vmovl_u8(c.val[0]), 249), 11);
+        uint16x8_t g = vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(505), vmovl_u8(c.val[1]), 253), 10);
+        uint16x8_t b = vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(1014), vmovl_u8(c.val[2]), 249), 11);
+        vst1q_u16(dst + i, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+    }
+#elif defined(SAI_SSSE3)
+    // Two 16 byte loads cover 8 pixels, stop early enough to not read past the end
+    const __m128i rLo = _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i gLo = _mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i bLo = _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i rHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, -1, 3, -1, 6, -1, 9, -1);
+    const __m128i gHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1, 10, -1);
+    const __m128i bHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 2, -1, 5, -1, 8, -1, 11, -1);
+    const __m128i mulRb = _mm_set1_epi16(249);
+    const __m128i addRb = _mm_set1_epi16(1014);
+    const __m128i mulG = _mm_set1_epi16(253);
+    const __m128i addG = _mm_set1_epi16(505);
+    for (; i + 10 <= n; i += 8) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i + 12));
+        __m128i r = _mm_or_si128(_mm_shuffle_epi8(lo, rLo), _mm_shuffle_epi8(hi, rHi));
+        __m128i g = _mm_or_si128(_mm_shuffle_epi8(lo, gLo), _mm_shuffle_epi8(hi, gHi));
+        __m128i b = _mm_or_si128(_mm_shuffle_epi8(lo, bLo), _mm_shuffle_epi8(hi, bHi));
+        r = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(r, mulRb), addRb), 11);
+        g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(g, mulG), addG), 10);
+        b = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(b, mulRb), addRb), 11);
+        __m128i packed = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+#endif
+    for (; i < n; ++i) dst[i] = rgb565(rgb[3 * i + 0], rgb[3 * i + 1], rgb[3 * i + 2]);
+}
+
+void decode_rgb565_to_rgba(const std::uint16_t* src, size_t n, std::uint8_t* dst) {
+    size_t i = 0;
+#if defined(SAI_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        uint16x8_t r = vshrq_n_u16(v, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(v, 5), vdupq_n_u16(63));
+        uint16x8_t b = vandq_u16(v, vdupq_n_u16(31));
+        uint8x8x4_t rgba;
+        rgba.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2)));
+        rgba.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4)));
+        rgba.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2)));
+        rgba.val[3] = vdup_n_u8(0xFF);
+        vst4_u8(dst + 4 * i, rgba);
+    }
+#elif defined(SAI_SSE2)
+    const __m128i mask6 = _mm_set1_epi16(63);
+    const __m128i mask5 = _mm_set1_epi16(31);
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i r = _mm_srli_epi16(v, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+        __m128i b = _mm_and_si128(v, mask5);
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+        __m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), alpha);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + 4 * i);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg, ba));
+    }
+#endif
+    for (; i < n; ++i) {
+        const std::uint16_t v = src[i];
+        const int r = v >> 11, g = (v >> 5) & 63, b = v & 31;
+        dst[4 * i + 0] = (std::uint8_t)((r << 3) | (r >> 2));
+        dst[4 * i + 1] = (std::uint8_t)((g << 2) | (g >> 4));
+        dst[4 * i + 2] = (std::uint8_t)((b << 3) | (b >> 2));
+        dst[4 * i + 3] = 0xFF;
+    }
+}
+
+void CompactPoints::encode(const float* srcPositions, const float* srcNormals, const std::uint8_t* rgb, size_t n, int normalBytes) {
+    box = quantization_box(srcPositions, n);
+    positions.resize(3 * n);
+    encode_positions(srcPositions, n, box, positions.data());
+
+    this->normalBytes = srcNormals && n > 0 ? normalBytes : 0;
+    normals.resize(this->normalBytes * n);
+    if (this->normalBytes > 0) encode_normals_oct(srcNormals, n, this->normalBytes, normals.data());
+
+    colors.resize(rgb ? n : 0);
+    if (rgb) encode_rgb565(rgb, n, colors.data());
+}
+
+} // namespace saiInternal
+
+struct INTERNAL_API CompactPointCloud {
+    saiInternal::CompactPoints points;
+};
+
+CompactPointCloud* sai_point_cloud_encode_compact(
+        PointCloudWrapper* pointCloudHandle,
+        int32_t normalBytes) {
+    assert(pointCloudHandle);
+    assert(normalBytes == 0 || normalBytes == 2 || normalBytes == 4);
+    const spectacularAI::mapping::PointCloud &pointCloud = *pointCloudHandle->getHandle();
+    const size_t n = pointCloud.size();
+    CompactPointCloud* compact = new CompactPointCloud();
+    if (n == 0) return compact;
+    compact->points.encode(
+        reinterpret_cast<const float*>(pointCloud.getPositionData()),
+        pointCloud.hasNormals() ? reinterpret_cast<const float*>(pointCloud.getNormalData()) : nullptr,
+        pointCloud.hasColors() ? pointCloud.getRGB24Data() : nullptr,
+        n,
+        normalBytes);
+    return compact;
+}
+
+void sai_compact_point_cloud_get(
+        const CompactPointCloud* compactPointCloudHandle,
+        CompactPointCloudWrapper* compactPointCloud) {
+    assert(compactPointCloudHandle);
+    assert(compactPointCloud);
+    const saiInternal::CompactPoints &points = compactPointCloudHandle->points;
+    CompactPointCloudWrapper &w = *compactPointCloud;
+    w.size = (int32_t)points.size();
+    w.normalBytes = points.normalBytes;
+    w.boundsMin = spectacularAI::Vector3f { points.box.offset[0], points.box.offset[1], points.box.offset[2] };
+    w.scale = spectacularAI::Vector3f { points.box.scale[0], points.box.scale[1], points.box.scale[2] };
+    w.positions = points.positions.empty() ? nullptr : points.positions.data();
+    w.normals = points.normals.empty() ? nullptr : points.normals.data();
+    w.colors = points.colors.empty() ? nullptr : points.colors.data();
+    w.bytes = points.bytes();
+}
+
+void sai_compact_point_cloud_decode_positions(
+        const CompactPointCloud* compactPointCloudHandle,
+        spectacularAI::Vector3f* positions) {
+    assert(compactPointCloudHandle);
+    const saiInternal::CompactPoints &points = compactPointCloudHandle->points;
+    saiInternal::decode_positions(points.positions.data(), points.size(), points.box, reinterpret_cast<float*>(positions));
+}
+
+bool sai_compact_point_cloud_decode_normals(
+        const CompactPointCloud* compactPointCloudHandle,
+        spectacularAI::Vector3f* normals) {
+    assert(compactPointCloudHandle);
+    const saiInternal::CompactPoints &points = compactPointCloudHandle->points;
+    if (points.normalBytes == 0) return false;
+    saiInternal::decode_normals_oct(points.normals.data(), points.size(), points.normalBytes, reinterpret_cast<float*>(normals));
+    return true;
+}
+
+bool sai_compact_point_cloud_decode_rgba32(
+        const CompactPointCloud* compactPointCloudHandle,
+        std::uint8_t* colors) {
+    assert(compactPointCloudHandle);
+    const saiInternal::CompactPoints &points = compactPointCloudHandle->points;
+    if (points.colors.empty()) return false;
+    saiInternal::decode_rgb565_to_rgba(points.colors.data(), points.size(), colors);
+    return true;
+}
+
+void sai_compact_point_cloud_release(CompactPointCloud* compactPointCloudHandle) {
+    if (compactPointCloudHandle) delete compactPointCloudHandle;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../include/spectacularAI/unity/types.hpp"
+
+/**
+ * Compact point encoding kernels shared by the compact point cloud API and the tile
+ * store. Not part of the C API. Positions and normals are 3 floats per point, colors RGB24.
+ */
+
+namespace saiInternal INTERNAL_API {
+
+/** Per-axis quantisation, decoded = offset + q * scale */
+struct QuantizationBox {
+    float offset[3];
+    float scale[3];
+};
+
+QuantizationBox quantization_box(const float* positions, size_t n);
+void encode_positions(const float* src, size_t n, const QuantizationBox &box, std::uint16_t* dst);
+void decode_positions(const std::uint16_t* src, size_t n, const QuantizationBox &box, float* dst);
+/** bytesPerNormal is 2 (2 x int8 snorm) or 4 (2 x int16 snorm) */
+void encode_normals_oct(const float* src, size_t n, int bytesPerNormal, std::uint8_t* dst);
+void decode_normals_oct(const std::uint8_t* src, size_t n, int bytesPerNormal, float* dst);
+void encode_rgb565(const std::uint8_t* rgb, size_t n, std::uint16_t* dst);
+void decode_rgb565_to_rgba(const std::uint16_t* src, size_t n, std::uint8_t* dst);
+
+struct CompactPoints {
+    QuantizationBox box = {};
+    int32_t normalBytes = 0; // 0 if there are no normals
+    std::vector<std::uint16_t> positions; // 3 per point
+    std::vector<std::uint8_t> normals; // normalBytes per point
+    std::vector<std::uint16_t> colors; // RGB565, empty if there are no colors
+
+    size_t size() const { return positions.size() / 3; }
+
+    int64_t bytes() const {
+        return (int64_t)(positions.size() * sizeof(std::uint16_t) + normals.size()
+            + colors.size() * sizeof(std::uint16_t));
+    }
+
+    /** normals and rgb may be null, normalBytes 0 drops the normals */
+    void encode(const float* srcPositions, const float* srcNormals, const std::uint8_t* rgb, size_t n, int normalBytes);
+};
+
+} // namespace saiInternal
@@ -1,4 +1,5 @@
 #include "../include/spectacularAI/unity/depthai.hpp"
+#include "mock_backend.hpp"
 
 #include <string>
 #include <depthai/depthai.hpp>
@@ -42,12 +43,23 @@ PipelineWrapper* sai_depthai_pipeline_build(
         ConfigurationWrapper* configuration,
         const char** internalParameters,
         int internalParametersCount,
-        callback_t_mapper_output onMapperOutput) {
-    std::shared_ptr<dai::Pipeline> pipeline = std::make_shared<dai::Pipeline>();
-
+        callback_t_mapper_output onMapperOutput,
+        const MockBackendConfigWrapper* mockBackend) {
     spectacularAI::daiPlugin::Configuration config;
     create_configuration(*configuration, internalParameters, internalParametersCount, config);
 
+    if (mockBackend) {
+        std::function<void(spectacularAI::mapping::MapperOutputPtr)> mapperCallback;
+        if (onMapperOutput) {
+            mapperCallback = [onMapperOutput](spectacularAI::mapping::MapperOutputPtr mapperOutput) {
+                onMapperOutput(new MapperOutputWrapper(mapperOutput));
+            };
+        }
+        return new PipelineWrapper(std::make_shared<MockBackend>(*mockBackend, config, mapperCallback));
+    }
+
+    std::shared_ptr<dai::Pipeline> pipeline = std::make_shared<dai::Pipeline>();
+
     std::shared_ptr<spectacularAI::daiPlugin::Pipeline> handle = onMapperOutput ?
         std::make_shared<spectacularAI::daiPlugin::Pipeline>(*pipeline, config,
             [onMapperOutput](spectacularAI::mapping::MapperOutputPtr mapperOutput) {
@@ -61,6 +73,7 @@ PipelineWrapper* sai_depthai_pipeline_build(
 spectacularAI::daiPlugin::Session* sai_depthai_pipeline_start_session(PipelineWrapper* pipelineHandle, char* errorMsg) {
     assert(pipelineHandle);
     try {
+        if (pipelineHandle->getMock()) return pipelineHandle->getMock()->startSession().release();
         return pipelineHandle->getHandle()->startSession(*pipelineHandle->getDevice()).release();
     } catch(const std::runtime_error &e) {
         if (errorMsg != nullptr) {
@@ -118,6 +131,7 @@ spectacularAI::CameraPose* sai_depthai_session_get_rgb_camera_pose(
         const VioOutputWrapper* vioOutputHandle) {
     assert(sessionHandle);
     spectacularAI::CameraPose* cameraPose = new spectacularAI::CameraPose();
+    ++HandleCounter<spectacularAI::CameraPose>::live;
     *cameraPose = sessionHandle->getRgbCameraPose(*vioOutputHandle->getHandle());
     return cameraPose;
 }
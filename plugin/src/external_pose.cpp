@@ -0,0 +1,382 @@
+#include "../include/spectacularAI/unity/external_pose.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double PI = 3.14159265358979323846;
+constexpr size_t MAX_VIO_HISTORY = 256;
+constexpr double GATE_SIGMAS = 3.0;
+
+struct VioSample {
+    double time;
+    spectacularAI::Vector3d position;
+    spectacularAI::Vector3d velocity;
+    spectacularAI::Quaternion orientation;
+    bool tracking;
+};
+
+double trace(const Matrix3dWrapper &m) {
+    return m.m00 + m.m11 + m.m22;
+}
+
+double quaternion_dot(const spectacularAI::Quaternion &a, const spectacularAI::Quaternion &b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+double angle_between(const spectacularAI::Quaternion &a, const spectacularAI::Quaternion &b) {
+    double d = std::min(std::fabs(quaternion_dot(a, b)), 1.0);
+    return 2 * std::acos(d);
+}
+
+spectacularAI::Vector3d extrapolate(const VioSample &s, double t) {
+    const double dt = t - s.time;
+    return {
+        s.position.x + s.velocity.x * dt,
+        s.position.y + s.velocity.y * dt,
+        s.position.z + s.velocity.z * dt
+    };
+}
+
+/** Inverse-variance weighted mean, covariances are averaged with the same weights (not shrunk) */
+ExternalPoseWrapper average(const std::vector<ExternalPoseWrapper> &samples) {
+    ExternalPoseWrapper mean;
+    std::memset(&mean, 0, sizeof(mean));
+    const spectacularAI::Quaternion &reference = samples.front().pose.orientation;
+    double totalWeight = 0;
+    bool orientationKnown = true;
+    for (const ExternalPoseWrapper &s : samples) {
+        const double w = 1.0 / std::max(trace(s.positionCovariance), 1e-12);
+        totalWeight += w;
+        mean.pose.time += w * s.pose.time;
+        mean.pose.position.x += w * s.pose.position.x;
+        mean.pose.position.y += w * s.pose.position.y;
+        mean.pose.position.z += w * s.pose.position.z;
+        // q and -q are the same rotation, sum them on the same hemisphere
+        const double sign = quaternion_dot(s.pose.orientation, reference) < 0 ? -w : w;
+        mean.pose.orientation.x += sign * s.pose.orientation.x;
+        mean.pose.orientation.y += sign * s.pose.orientation.y;
+        mean.pose.orientation.z += sign * s.pose.orientation.z;
+        mean.pose.orientation.w += sign * s.pose.orientation.w;
+        const double* src = &s.positionCovariance.m00;
+        double* dst = &mean.positionCovariance.m00;
+        for (int i = 0; i < 9; ++i) dst[i] += w * src[i];
+        if (s.orientationVariance < 0) orientationKnown = false;
+        mean.orientationVariance += w * s.orientationVariance;
+    }
+
+    mean.pose.time /= totalWeight;
+    mean.pose.position.x /= totalWeight;
+    mean.pose.position.y /= totalWeight;
+    mean.pose.position.z /= totalWeight;
+    double* cov = &mean.positionCovariance.m00;
+    for (int i = 0; i < 9; ++i) cov[i] /= totalWeight;
+    double norm = std::sqrt(quaternion_dot(mean.pose.orientation, mean.pose.orientation));
+    if (norm > 0) {
+        mean.pose.orientation.x /= norm;
+        mean.pose.orientation.y /= norm;
+        mean.pose.orientation.z /= norm;
+        mean.pose.orientation.w /= norm;
+    } else {
+        mean.pose.orientation = reference;
+    }
+    mean.orientationVariance = orientationKnown ? mean.orientationVariance / totalWeight : -1;
+    return mean;
+}
+
+} // anonymous namespace
+
+struct ExternalPoseQueue {
+    ExternalPoseQueue(spectacularAI::daiPlugin::Session* session, const ExternalPoseQueueConfigWrapper &config) :
+        session(session), config(config), gateOpenUntil(config.gateAfterForwarded)
+    {
+        worker = std::thread([this]() { run(); });
+    }
+
+    ~ExternalPoseQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shouldQuit = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    void addVioOutput(const spectacularAI::VioOutput &output) {
+        std::lock_guard<std::mutex> lock(vioMutex);
+        // Trigger outputs can be out of order, the history only needs the regular stream
+        if (!vioHistory.empty() && output.pose.time <= vioHistory.back().time) return;
+        vioHistory.push_back({
+            output.pose.time,
+            output.pose.position,
+            output.velocity,
+            output.pose.orientation,
+            output.status == spectacularAI::TrackingStatus::TRACKING
+        });
+        if (vioHistory.size() > MAX_VIO_HISTORY) vioHistory.pop_front();
+    }
+
+    int32_t push(const ExternalPoseWrapper* poses, int32_t count) {
+        int32_t queued = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const size_t space = (size_t)config.capacity - std::min(pending.size(), (size_t)config.capacity);
+            queued = (int32_t)std::min((size_t)count, space);
+            pending.insert(pending.end(), poses, poses + queued);
+        }
+        received += count;
+        dropped += count - queued;
+        if (queued > 0) wake.notify_one();
+        return queued;
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        const int64_t target = ++flushRequested;
+        wake.notify_one();
+        flushed.wait(lock, [this, target]() { return flushCompleted >= target || shouldQuit; });
+    }
+
+    ExternalPoseQueueStatsWrapper stats() const {
+        ExternalPoseQueueStatsWrapper s;
+        std::lock_guard<std::mutex> lock(mutex);
+        s.received = received;
+        s.accepted = accepted;
+        s.rejected = rejected;
+        s.reacquisitions = reacquisitions;
+        s.decimated = decimated;
+        s.dropped = dropped;
+        s.forwarded = forwarded;
+        s.pending = (int32_t)pending.size();
+        s.meanForwardMs = forwarded > 0 ? forwardMsTotal / forwarded : 0;
+        s.maxForwardMs = forwardMsMax;
+        return s;
+    }
+
+private:
+    void run() {
+        const auto period = std::chrono::duration<double>(config.fusionRateHz > 0 ? 1.0 / config.fusionRateHz : 0.1);
+        std::vector<ExternalPoseWrapper> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            auto ready = [this]() { return !pending.empty() || flushRequested > flushCompleted || shouldQuit; };
+            // An open fusion period is forwarded if no samples arrive for one period
+            bool woken = bin.empty() ? (wake.wait(lock, ready), true) : wake.wait_for(lock, period, ready);
+            if (shouldQuit) break;
+
+            batch.assign(pending.begin(), pending.end());
+            pending.clear();
+            const int64_t flushTarget = flushRequested;
+            lock.unlock();
+
+            for (const ExternalPoseWrapper &sample : batch) process(sample);
+            if (!woken || flushTarget > flushCompleted) forwardBin();
+
+            lock.lock();
+            if (flushTarget > flushCompleted) {
+                flushCompleted = flushTarget;
+                flushed.notify_all();
+            }
+        }
+        flushed.notify_all();
+    }
+
+    // Worker thread only
+    void process(const ExternalPoseWrapper &sample) {
+        if (sample.pose.time <= lastForwardedTime) {
+            ++rejected;
+            return;
+        }
+        if (isOutlier(sample)) {
+            ++rejected;
+            if (config.reacquireAfterRejections > 0 && ++consecutiveRejections >= config.reacquireAfterRejections) {
+                // Drifted or re-aligned VIO would otherwise reject everything from now on
+                gateOpenUntil = forwarded + config.gateAfterForwarded;
+                consecutiveRejections = 0;
+                ++reacquisitions;
+            }
+            return;
+        }
+        consecutiveRejections = 0;
+        ++accepted;
+
+        if (!(config.fusionRateHz > 0)) {
+            forward(sample);
+            return;
+        }
+        const int64_t samplePeriod = (int64_t)std::floor(sample.pose.time * config.fusionRateHz);
+        if (!bin.empty() && samplePeriod > binPeriod) forwardBin();
+        if (bin.empty()) binPeriod = samplePeriod;
+        bin.push_back(sample);
+    }
+
+    bool isOutlier(const ExternalPoseWrapper &sample) {
+        if (forwarded < gateOpenUntil) return false;
+
+        VioSample estimate;
+        if (!vioEstimate(sample.pose.time, estimate)) return false;
+
+        if (config.maxPositionError > 0) {
+            const double dx = sample.pose.position.x - estimate.position.x;
+            const double dy = sample.pose.position.y - estimate.position.y;
+            const double dz = sample.pose.position.z - estimate.position.z;
+            const double limit = config.maxPositionError
+                + GATE_SIGMAS * std::sqrt(std::max(trace(sample.positionCovariance), 0.0));
+            if (std::sqrt(dx * dx + dy * dy + dz * dz) > limit) return true;
+        }
+
+        if (config.maxOrientationErrorDegrees > 0 && sample.orientationVariance >= 0) {
+            const double limit = config.maxOrientationErrorDegrees * PI / 180
+                + GATE_SIGMAS * std::sqrt(sample.orientationVariance);
+            if (angle_between(sample.pose.orientation, estimate.orientation) > limit) return true;
+        }
+        return false;
+    }
+
+    /** VIO pose at time t, interpolated or extrapolated by at most maxTimeOffset */
+    bool vioEstimate(double t, VioSample &estimate) {
+        std::lock_guard<std::mutex> lock(vioMutex);
+        if (vioHistory.empty() || !vioHistory.back().tracking) return false;
+
+        const VioSample &first = vioHistory.front();
+        const VioSample &last = vioHistory.back();
+        if (t >= last.time || t <= first.time) {
+            const VioSample &nearest = t >= last.time ? last : first;
+            if (std::fabs(t - nearest.time) > config.maxTimeOffset || !nearest.tracking) return false;
+            estimate = nearest;
+            estimate.position = extrapolate(nearest, t);
+            return true;
+        }
+
+        auto after = std::upper_bound(vioHistory.begin(), vioHistory.end(), t,
+            [](double time, const VioSample &s) { return time < s.time; });
+        const VioSample &a = *(after - 1);
+        const VioSample &b = *after;
+        if (!a.tracking || !b.tracking) return false;
+        const double u = (t - a.time) / (b.time - a.time);
+        estimate = u < 0.5 ? a : b;
+        estimate.position = {
+            a.position.x + u * (b.position.x - a.position.x),
+            a.position.y + u * (b.position.y - a.position.y),
+            a.position.z + u * (b.position.z - a.position.z)
+        };
+        return true;
+    }
+
+    void forwardBin() {
+        if (bin.empty()) return;
+        if (bin.size() == 1 || config.merge == ExternalPoseMerge::AVERAGE) {
+            forward(bin.size() == 1 ? bin.front() : average(bin));
+        } else {
+            forward(*std::max_element(bin.begin(), bin.end(),
+                [](const ExternalPoseWrapper &a, const ExternalPoseWrapper &b) { return a.pose.time < b.pose.time; }));
+        }
+        decimated += (int64_t)bin.size() - 1;
+        bin.clear();
+    }
+
+    void forward(const ExternalPoseWrapper &sample) {
+        const auto start = Clock::now();
+        session->addAbsolutePose(
+            sample.pose,
+            reinterpret_cast<const spectacularAI::Matrix3d&>(sample.positionCovariance),
+            sample.orientationVariance);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        lastForwardedTime = std::max(lastForwardedTime, sample.pose.time);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++forwarded;
+        forwardMsTotal += ms;
+        forwardMsMax = std::max(forwardMsMax, ms);
+    }
+
+    spectacularAI::daiPlugin::Session* const session;
+    const ExternalPoseQueueConfigWrapper config;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    bool shouldQuit = false;
+    std::deque<ExternalPoseWrapper> pending;
+    int64_t flushRequested = 0;
+    int64_t flushCompleted = 0;
+    double forwardMsTotal = 0;
+    double forwardMsMax = 0;
+
+    std::atomic<int64_t> received { 0 };
+    std::atomic<int64_t> accepted { 0 };
+    std::atomic<int64_t> rejected { 0 };
+    std::atomic<int64_t> reacquisitions { 0 };
+    std::atomic<int64_t> decimated { 0 };
+    std::atomic<int64_t> dropped { 0 };
+    std::atomic<int64_t> forwarded { 0 };
+
+    std::mutex vioMutex;
+    std::deque<VioSample> vioHistory;
+
+    // Worker thread only
+    std::vector<ExternalPoseWrapper> bin; // accepted samples of the open fusion period
+    int64_t binPeriod = 0;
+    double lastForwardedTime = -1e300;
+    int64_t gateOpenUntil; // no outlier checks before this many poses have been forwarded
+    int32_t consecutiveRejections = 0;
+
+    std::thread worker;
+};
+
+ExternalPoseQueue* sai_external_pose_queue_create(
+        spectacularAI::daiPlugin::Session* sessionHandle,
+        const ExternalPoseQueueConfigWrapper* config,
+        char* errorMsg) {
+    assert(sessionHandle);
+    assert(config);
+    if (config->fusionRateHz < 0 || config->capacity <= 0 || config->maxTimeOffset < 0) {
+        if (errorMsg) std::strncpy(errorMsg, "ExternalPoseQueue: fusion rate and time offset must be non-negative and capacity positive", 1000 - 1);
+        return nullptr;
+    }
+    return new ExternalPoseQueue(sessionHandle, *config);
+}
+
+void sai_external_pose_queue_add_vio_output(
+        ExternalPoseQueue* queueHandle,
+        const VioOutputWrapper* vioOutputHandle) {
+    assert(queueHandle);
+    assert(vioOutputHandle);
+    queueHandle->addVioOutput(*vioOutputHandle->getHandle());
+}
+
+int32_t sai_external_pose_queue_push(
+        ExternalPoseQueue* queueHandle,
+        const ExternalPoseWrapper* poses,
+        int32_t count) {
+    assert(queueHandle);
+    if (count <= 0) return 0;
+    assert(poses);
+    return queueHandle->push(poses, count);
+}
+
+void sai_external_pose_queue_flush(ExternalPoseQueue* queueHandle) {
+    assert(queueHandle);
+    queueHandle->flush();
+}
+
+ExternalPoseQueueStatsWrapper sai_external_pose_queue_get_stats(ExternalPoseQueue* queueHandle) {
+    assert(queueHandle);
+    return queueHandle->stats();
+}
+
+void sai_external_pose_queue_release(ExternalPoseQueue* queueHandle) {
+    if (queueHandle) delete queueHandle;
+}
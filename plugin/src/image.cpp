@@ -0,0 +1,232 @@
+#include "../include/spectacularAI/unity/image.hpp"
+#include "image_rows.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SAI_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SAI_SSE2
+    #if defined(__SSSE3__) || defined(__AVX__)
+        #include <tmmintrin.h>
+        #define SAI_SSSE3
+    #endif
+#endif
+
+namespace saiInternal {
+
+void gray_to_rgba_row(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+#if defined(SAI_NEON)
+    const uint8x16_t alpha = vdupq_n_u8(0xFF);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t g = vld1q_u8(src + x);
+        uint8x16x4_t rgba = {{ g, g, g, alpha }};
+        vst4q_u8(dst + 4 * x, rgba);
+    }
+#elif defined(SAI_SSE2)
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    for (; x + 16 <= width; x += 16) {
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i gg0 = _mm_unpacklo_epi8(g, g);
+        __m128i gg1 = _mm_unpackhi_epi8(g, g);
+        __m128i ga0 = _mm_unpacklo_epi8(g, alpha);
+        __m128i ga1 = _mm_unpackhi_epi8(g, alpha);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + 4 * x);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(gg0, ga0));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(gg0, ga0));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(gg1, ga1));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(gg1, ga1));
+    }
+#endif
+    for (; x < width; ++x) {
+        std::uint8_t g = src[x];
+        dst[4 * x + 0] = g;
+        dst[4 * x + 1] = g;
+        dst[4 * x + 2] = g;
+        dst[4 * x + 3] = 0xFF;
+    }
+}
+
+void rgb_to_rgba_row(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+#if defined(SAI_NEON)
+    const uint8x16_t alpha = vdupq_n_u8(0xFF);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x3_t rgb = vld3q_u8(src + 3 * x);
+        uint8x16x4_t rgba = {{ rgb.val[0], rgb.val[1], rgb.val[2], alpha }};
+        vst4q_u8(dst + 4 * x, rgba);
+    }
+#elif defined(SAI_SSSE3)
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    // Each 16 byte load covers 4 pixels (12 bytes), stop early enough to not read past the row
+    for (; x + 6 <= width; x += 4) {
+        __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * x));
+        __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x), rgba);
+    }
+#endif
+    for (; x < width; ++x) {
+        dst[4 * x + 0] = src[3 * x + 0];
+        dst[4 * x + 1] = src[3 * x + 1];
+        dst[4 * x + 2] = src[3 * x + 2];
+        dst[4 * x + 3] = 0xFF;
+    }
+}
+
+void gray8_to_r16_row(const std::uint8_t* src, std::uint16_t* dst, int width) {
+    int x = 0;
+#if defined(SAI_NEON)
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t g = vld1q_u8(src + x);
+        // v * 257 maps 0..255 to 0..65535
+        uint8x16x2_t gg = {{ g, g }};
+        vst2q_u8(reinterpret_cast<std::uint8_t*>(dst + x), gg);
+    }
+#elif defined(SAI_SSE2)
+    for (; x + 16 <= width; x += 16) {
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i* out = reinterpret_cast<__m128i*>(dst + x);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(g, g));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(g, g));
+    }
+#endif
+    for (; x < width; ++x) dst[x] = (std::uint16_t)(src[x] * 257);
+}
+
+} // namespace saiInternal
+
+namespace {
+
+// Split work so that each task handles roughly this many pixels
+constexpr int PIXELS_PER_TASK = 64 * 1024;
+
+bool get_image(FrameWrapper* frameHandle, ImageViewWrapper &view) {
+    assert(frameHandle);
+    return sai_frame_get_image(frameHandle, &view) && view.width > 0 && view.height > 0;
+}
+
+template<typename RowFn>
+void for_each_row(const ImageViewWrapper &view, std::uint8_t* dst, int dstStride, bool flipVertically, RowFn rowFn) {
+    ThreadPool::shared().parallelFor(view.height, std::max(1, PIXELS_PER_TASK / view.width),
+        [&](int begin, int end) {
+            for (int y = begin; y < end; ++y) {
+                int dstY = flipVertically ? view.height - 1 - y : y;
+                rowFn(view.data + (size_t)y * view.stride, dst + (size_t)dstY * dstStride);
+            }
+        });
+}
+
+} // anonymous namespace
+
+bool sai_frame_convert_to_rgba32(
+        FrameWrapper* frameHandle,
+        std::uint8_t* dst,
+        int32_t dstStride,
+        bool flipVertically) {
+    assert(dst);
+    ImageViewWrapper view;
+    if (!get_image(frameHandle, view)) return false;
+    if (dstStride <= 0) dstStride = 4 * view.width;
+    const int width = view.width;
+
+    switch (view.format) {
+        case ImageFormat::GRAY8:
+            for_each_row(view, dst, dstStride, flipVertically,
+                [width](const std::uint8_t* s, std::uint8_t* d) { saiInternal::gray_to_rgba_row(s, d, width); });
+            return true;
+        case ImageFormat::RGB24:
+            for_each_row(view, dst, dstStride, flipVertically,
+                [width](const std::uint8_t* s, std::uint8_t* d) { saiInternal::rgb_to_rgba_row(s, d, width); });
+            return true;
+        case ImageFormat::RGBA32:
+            for_each_row(view, dst, dstStride, flipVertically,
+                [width](const std::uint8_t* s, std::uint8_t* d) { std::memcpy(d, s, 4 * (size_t)width); });
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool sai_frame_convert_to_r16(
+        FrameWrapper* frameHandle,
+        std::uint16_t* dst,
+        int32_t dstStride,
+        bool flipVertically) {
+    assert(dst);
+    ImageViewWrapper view;
+    if (!get_image(frameHandle, view)) return false;
+    if (dstStride <= 0) dstStride = 2 * view.width;
+    const int width = view.width;
+    std::uint8_t* dstBytes = reinterpret_cast<std::uint8_t*>(dst);
+
+    switch (view.format) {
+        case ImageFormat::GRAY16:
+            for_each_row(view, dstBytes, dstStride, flipVertically,
+                [width](const std::uint8_t* s, std::uint8_t* d) { std::memcpy(d, s, 2 * (size_t)width); });
+            return true;
+        case ImageFormat::GRAY8:
+            for_each_row(view, dstBytes, dstStride, flipVertically,
+                [width](const std::uint8_t* s, std::uint8_t* d) {
+                    saiInternal::gray8_to_r16_row(s, reinterpret_cast<std::uint16_t*>(d), width);
+                });
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool sai_frame_convert_to_rgba32_thumbnail(
+        FrameWrapper* frameHandle,
+        std::uint8_t* dst,
+        int32_t dstWidth,
+        int32_t dstHeight,
+        bool flipVertically) {
+    assert(dst);
+    ImageViewWrapper view;
+    if (!get_image(frameHandle, view) || dstWidth <= 0 || dstHeight <= 0) return false;
+
+    int channels;
+    switch (view.format) {
+        case ImageFormat::GRAY8: channels = 1; break;
+        case ImageFormat::RGB24: channels = 3; break;
+        case ImageFormat::RGBA32: channels = 4; break;
+        default: return false;
+    }
+
+    // Box filter, each destination pixel averages the source pixels it covers
+    ThreadPool::shared().parallelFor(dstHeight, std::max(1, PIXELS_PER_TASK / std::max(1, view.width * (view.height / dstHeight + 1))),
+        [&](int begin, int end) {
+            for (int y = begin; y < end; ++y) {
+                int y0 = (int)((int64_t)y * view.height / dstHeight);
+                int y1 = std::max(y0 + 1, (int)((int64_t)(y + 1) * view.height / dstHeight));
+                std::uint8_t* out = dst + 4 * (size_t)dstWidth * (flipVertically ? dstHeight - 1 - y : y);
+                for (int x = 0; x < dstWidth; ++x) {
+                    int x0 = (int)((int64_t)x * view.width / dstWidth);
+                    int x1 = std::max(x0 + 1, (int)((int64_t)(x + 1) * view.width / dstWidth));
+                    uint32_t sum[3] = { 0, 0, 0 };
+                    for (int sy = y0; sy < y1; ++sy) {
+                        const std::uint8_t* row = view.data + (size_t)sy * view.stride;
+                        for (int sx = x0; sx < x1; ++sx) {
+                            const std::uint8_t* p = row + channels * sx;
+                            sum[0] += p[0];
+                            sum[1] += p[channels > 1 ? 1 : 0];
+                            sum[2] += p[channels > 1 ? 2 : 0];
+                        }
+                    }
+                    uint32_t count = (uint32_t)((y1 - y0) * (x1 - x0));
+                    out[4 * x + 0] = (std::uint8_t)((sum[0] + count / 2) / count);
+                    out[4 * x + 1] = (std::uint8_t)((sum[1] + count / 2) / count);
+                    out[4 * x + 2] = (std::uint8_t)((sum[2] + count / 2) / count);
+                    out[4 * x + 3] = 0xFF;
+                }
+            }
+        });
+    return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../include/spectacularAI/unity/types.hpp"
+
+/** SIMD row kernels shared by the native conversions. Not part of the C API. */
+namespace saiInternal INTERNAL_API {
+
+void gray_to_rgba_row(const std::uint8_t* src, std::uint8_t* dst, int width);
+void rgb_to_rgba_row(const std::uint8_t* src, std::uint8_t* dst, int width);
+void gray8_to_r16_row(const std::uint8_t* src, std::uint16_t* dst, int width);
+
+} // namespace saiInternal
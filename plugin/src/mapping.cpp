@@ -112,6 +112,7 @@ void sai_frame_set_release(FrameSetWrapper* frameSetHandle) {
 spectacularAI::CameraPose* sai_frame_get_camera_pose(FrameWrapper* frameHandle) {
     assert(frameHandle);
     spectacularAI::CameraPose* cameraPose = new spectacularAI::CameraPose();
+    ++HandleCounter<spectacularAI::CameraPose>::live;
     *cameraPose = frameHandle->getHandle()->cameraPose;
     return cameraPose;
 }
@@ -121,6 +122,29 @@ double sai_frame_get_depth_scale(FrameWrapper* frameHandle) {
     return frameHandle->getHandle()->depthScale;
 }
 
+bool sai_frame_get_image(FrameWrapper* frameHandle, ImageViewWrapper* imageView) {
+    assert(frameHandle);
+    assert(imageView);
+    *imageView = ImageViewWrapper { 0, 0, 0, ImageFormat::NONE, nullptr };
+    const std::shared_ptr<const spectacularAI::Image> &image = frameHandle->getHandle()->image;
+    if (!image || !image->getDataReadOnly()) return false;
+
+    int bytesPerPixel = 0;
+    switch (image->getColorFormat()) {
+        case spectacularAI::ColorFormat::GRAY: imageView->format = ImageFormat::GRAY8; bytesPerPixel = 1; break;
+        case spectacularAI::ColorFormat::GRAY16: imageView->format = ImageFormat::GRAY16; bytesPerPixel = 2; break;
+        case spectacularAI::ColorFormat::RGB: imageView->format = ImageFormat::RGB24; bytesPerPixel = 3; break;
+        case spectacularAI::ColorFormat::RGBA: imageView->format = ImageFormat::RGBA32; bytesPerPixel = 4; break;
+        default: return false;
+    }
+
+    imageView->width = image->getWidth();
+    imageView->height = image->getHeight();
+    imageView->stride = imageView->width * bytesPerPixel;
+    imageView->data = image->getDataReadOnly();
+    return true;
+}
+
 void sai_frame_release(FrameWrapper* frameHandle) {
     if (frameHandle) delete frameHandle;
 }
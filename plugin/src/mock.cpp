@@ -0,0 +1,530 @@
+#include "mock_backend.hpp"
+#include "../include/spectacularAI/unity/util.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double STEREO_BASELINE = 0.075; // meters, secondary camera to the right of the primary
+constexpr double RGB_OFFSET = 0.0375;
+constexpr size_t MAX_PENDING_KEY_FRAMES = 16;
+
+double seconds_since_epoch(Clock::time_point t) {
+    return std::chrono::duration<double>(t.time_since_epoch()).count();
+}
+
+struct TrajectorySample {
+    spectacularAI::Vector3d position;
+    double yaw; // heading in the world x-y plane, 0 is +x
+};
+
+TrajectorySample sample_trajectory(const MockBackendConfigWrapper &c, double t) {
+    const double r = std::max(c.radius, 0.01);
+    const double w = c.speed / r;
+    switch (c.trajectory) {
+        case MockTrajectory::LINE:
+            return { { c.speed * t, 0, 0 }, 0 };
+        case MockTrajectory::CIRCLE:
+            return { { r * std::sin(w * t), r * (1 - std::cos(w * t)), 0 }, w * t };
+        case MockTrajectory::FIGURE_EIGHT:
+            // Lemniscate of Gerono, heading along the derivative
+            return {
+                { r * std::sin(w * t), 0.5 * r * std::sin(2 * w * t), 0 },
+                std::atan2(std::cos(2 * w * t), std::cos(w * t))
+            };
+        case MockTrajectory::STATIC:
+        default:
+            return { { 0, 0, 0 }, 0 };
+    }
+}
+
+double wrap_angle(double a) {
+    while (a > PI) a -= 2 * PI;
+    while (a < -PI) a += 2 * PI;
+    return a;
+}
+
+/** Primary camera -> world, camera looks along the heading with y down */
+spectacularAI::Matrix4d camera_to_world(const TrajectorySample &s) {
+    const double c = std::cos(s.yaw), sn = std::sin(s.yaw);
+    return {{
+        { sn, 0, c, s.position.x },
+        { -c, 0, sn, s.position.y },
+        { 0, -1, 0, s.position.z },
+        { 0, 0, 0, 1 }
+    }};
+}
+
+spectacularAI::Matrix4d translation_x(double x) {
+    return {{
+        { 1, 0, 0, x },
+        { 0, 1, 0, 0 },
+        { 0, 0, 1, 0 },
+        { 0, 0, 0, 1 }
+    }};
+}
+
+spectacularAI::Matrix3d diagonal(double v) {
+    return {{ { v, 0, 0 }, { 0, v, 0 }, { 0, 0, v } }};
+}
+
+std::shared_ptr<const spectacularAI::Camera> build_camera(double focalLength, int width, int height) {
+    spectacularAI::Matrix3d intrinsics = {{
+        { focalLength, 0, 0.5 * width },
+        { 0, focalLength, 0.5 * height },
+        { 0, 0, 1 }
+    }};
+    return spectacularAI::Camera::buildPinhole(intrinsics, width, height);
+}
+
+/** Fixed camera rig of the synthetic device, shared by the session and its outputs */
+struct MockRig {
+    std::shared_ptr<const spectacularAI::Camera> primary = build_camera(285, 640, 400);
+    std::shared_ptr<const spectacularAI::Camera> secondary = build_camera(285, 640, 400);
+    std::shared_ptr<const spectacularAI::Camera> rgb = build_camera(1000, 1920, 1080);
+
+    spectacularAI::CameraPose cameraPose(
+            const spectacularAI::VioOutput &output,
+            const std::shared_ptr<const spectacularAI::Camera> &camera,
+            double offset) const {
+        spectacularAI::CameraPose cameraPose;
+        cameraPose.pose = spectacularAI::Pose::fromMatrix(
+            output.pose.time,
+            matrix_multiply(output.pose.asMatrix(), translation_x(offset)));
+        cameraPose.velocity = output.velocity;
+        cameraPose.camera = camera;
+        return cameraPose;
+    }
+};
+
+struct MockVioOutput : spectacularAI::VioOutput {
+    std::shared_ptr<const MockRig> rig;
+
+    spectacularAI::CameraPose getCameraPose(int cameraId) const override {
+        if (cameraId == 0) return rig->cameraPose(*this, rig->primary, 0);
+        return rig->cameraPose(*this, rig->secondary, STEREO_BASELINE);
+    }
+
+    std::string asJson() const override {
+        std::ostringstream json;
+        json.precision(17);
+        json << "{\"time\":" << pose.time
+            << ",\"position\":{\"x\":" << pose.position.x << ",\"y\":" << pose.position.y << ",\"z\":" << pose.position.z << "}"
+            << ",\"orientation\":{\"x\":" << pose.orientation.x << ",\"y\":" << pose.orientation.y
+            << ",\"z\":" << pose.orientation.z << ",\"w\":" << pose.orientation.w << "}"
+            << ",\"velocity\":{\"x\":" << velocity.x << ",\"y\":" << velocity.y << ",\"z\":" << velocity.z << "}"
+            << ",\"status\":" << (int)status << ",\"tag\":" << tag << "}";
+        return json.str();
+    }
+};
+
+struct KeyFrameRequest {
+    int64_t id;
+    spectacularAI::CameraPose cameraPose;
+    spectacularAI::Vector3d angularVelocity;
+};
+
+class MockSession : public spectacularAI::daiPlugin::Session {
+public:
+    MockSession(
+            const MockBackendConfigWrapper &config,
+            const std::function<void(spectacularAI::mapping::MapperOutputPtr)> &onMapperOutput) :
+        config(config),
+        onMapperOutput(onMapperOutput),
+        rig(std::make_shared<MockRig>()),
+        wallStart(Clock::now()),
+        timeOffset(seconds_since_epoch(wallStart)),
+        random(config.seed)
+    {
+        generatorThread = std::thread([this]() { generate(); });
+        if (mappingEnabled()) mapperThread = std::thread([this]() { map(); });
+    }
+
+    ~MockSession() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shouldQuit = true;
+        }
+        outputReady.notify_all();
+        spaceAvailable.notify_all();
+        keyFrameReady.notify_all();
+        if (generatorThread.joinable()) generatorThread.join();
+        if (mapperThread.joinable()) mapperThread.join();
+
+        if (mappingEnabled()) {
+            auto output = std::make_shared<spectacularAI::mapping::MapperOutput>();
+            output->map = buildMap();
+            output->finalMap = true;
+            onMapperOutput(output);
+            ++mapperOutputs;
+        }
+    }
+
+    bool hasOutput() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !outputs.empty();
+    }
+
+    spectacularAI::VioOutputPtr getOutput() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return popOutput();
+    }
+
+    spectacularAI::VioOutputPtr waitForOutput() override {
+        std::unique_lock<std::mutex> lock(mutex);
+        outputReady.wait(lock, [this]() { return !outputs.empty() || shouldQuit; });
+        return popOutput();
+    }
+
+    void addTrigger(double t, int tag) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        triggers.insert(std::make_pair(t, tag));
+    }
+
+    void addAbsolutePose(
+            const spectacularAI::Pose &pose,
+            const spectacularAI::Matrix3d &positionCovariance,
+            double orientationVariance) override {
+        // Not fused, the synthetic trajectory is the ground truth
+        (void)pose;
+        (void)positionCovariance;
+        (void)orientationVariance;
+        ++absolutePoses;
+    }
+
+    spectacularAI::CameraPose getRgbCameraPose(const spectacularAI::VioOutput &vioOutput) const override {
+        return rig->cameraPose(vioOutput, rig->rgb, RGB_OFFSET);
+    }
+
+    MockSessionStatsWrapper getStats() const {
+        MockSessionStatsWrapper stats;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.queuedOutputs = (int32_t)outputs.size();
+        }
+        stats.outputs = generated;
+        stats.triggerOutputs = triggerOutputs;
+        stats.droppedOutputs = dropped;
+        stats.trackingStatusChanges = trackingStatusChanges;
+        stats.keyFrames = keyFramesCreated;
+        stats.mapperOutputs = mapperOutputs;
+        stats.points = points;
+        stats.absolutePoses = absolutePoses;
+        stats.simulatedSeconds = simulatedSeconds;
+        stats.wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+        return stats;
+    }
+
+private:
+    bool mappingEnabled() const {
+        return onMapperOutput && config.keyFrameRateHz > 0;
+    }
+
+    // Call with the mutex locked
+    spectacularAI::VioOutputPtr popOutput() {
+        if (outputs.empty()) return nullptr;
+        spectacularAI::VioOutputPtr output = outputs.front();
+        outputs.pop_front();
+        spaceAvailable.notify_one();
+        return output;
+    }
+
+    spectacularAI::TrackingStatus trackingStatus(double t) const {
+        if (t < config.initSeconds) return spectacularAI::TrackingStatus::INIT;
+        if (config.lostTrackingIntervalSeconds > 0) {
+            double phase = std::fmod(t - config.initSeconds, config.lostTrackingIntervalSeconds + config.lostTrackingSeconds);
+            if (phase >= config.lostTrackingIntervalSeconds) return spectacularAI::TrackingStatus::LOST_TRACKING;
+        }
+        return spectacularAI::TrackingStatus::TRACKING;
+    }
+
+    std::shared_ptr<MockVioOutput> buildOutput(double t, int tag) {
+        auto output = std::make_shared<MockVioOutput>();
+        output->rig = rig;
+        output->status = trackingStatus(t);
+        output->tag = tag;
+
+        // Motion starts when tracking does, VIO reports the origin while initializing
+        const double motionT = std::max(t - config.initSeconds, 0.0);
+        const double h = 1e-3;
+        TrajectorySample s = sample_trajectory(config, motionT);
+        spectacularAI::Vector3d velocity = { 0, 0, 0 };
+        spectacularAI::Vector3d acceleration = { 0, 0, 0 };
+        double yawRate = 0;
+        if (output->status != spectacularAI::TrackingStatus::INIT) {
+            TrajectorySample prev = sample_trajectory(config, motionT - h);
+            TrajectorySample next = sample_trajectory(config, motionT + h);
+            velocity = {
+                (next.position.x - prev.position.x) / (2 * h),
+                (next.position.y - prev.position.y) / (2 * h),
+                (next.position.z - prev.position.z) / (2 * h)
+            };
+            acceleration = {
+                (next.position.x - 2 * s.position.x + prev.position.x) / (h * h),
+                (next.position.y - 2 * s.position.y + prev.position.y) / (h * h),
+                (next.position.z - 2 * s.position.z + prev.position.z) / (h * h)
+            };
+            yawRate = wrap_angle(next.yaw - prev.yaw) / (2 * h);
+        }
+
+        if (config.positionNoise > 0) {
+            std::normal_distribution<double> noise(0, config.positionNoise);
+            s.position.x += noise(random);
+            s.position.y += noise(random);
+            s.position.z += noise(random);
+        }
+
+        output->pose = spectacularAI::Pose::fromMatrix(timeOffset + t, camera_to_world(s));
+        output->velocity = velocity;
+        output->angularVelocity = { 0, 0, yawRate };
+        output->acceleration = acceleration;
+
+        double sigma = std::max(config.positionNoise, 0.01);
+        if (output->status == spectacularAI::TrackingStatus::LOST_TRACKING) sigma *= 10;
+        output->positionCovariance = diagonal(sigma * sigma);
+        output->velocityCovariance = diagonal(1e-4);
+        return output;
+    }
+
+    void pushOutput(spectacularAI::VioOutputPtr output) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const size_t capacity = (size_t)std::max(config.maxQueuedOutputs, 1);
+            if (config.realTime) {
+                while (outputs.size() >= capacity) {
+                    outputs.pop_front();
+                    ++dropped;
+                }
+            } else {
+                spaceAvailable.wait(lock, [this, capacity]() { return outputs.size() < capacity || shouldQuit; });
+                if (shouldQuit) return;
+            }
+            outputs.push_back(output);
+        }
+        ++generated;
+        outputReady.notify_one();
+    }
+
+    void generate() {
+        const double dt = 1.0 / config.outputRateHz;
+        const double keyFrameInterval = config.keyFrameRateHz > 0 ? 1.0 / config.keyFrameRateHz : 0;
+        std::uniform_real_distribution<double> jitter(0, std::max(config.timingJitterSeconds, 0.0));
+        spectacularAI::TrackingStatus previousStatus = spectacularAI::TrackingStatus::INIT;
+        double nextKeyFrameT = 0;
+        int64_t nextKeyFrameId = 1;
+
+        for (int64_t k = 0; ; ++k) {
+            const double t = k * dt;
+            std::vector<std::pair<double, int>> dueTriggers;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (config.realTime) {
+                    double delay = config.timingJitterSeconds > 0 ? jitter(random) : 0;
+                    auto due = wallStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(t + delay));
+                    spaceAvailable.wait_until(lock, due, [this]() { return shouldQuit; });
+                }
+                if (shouldQuit) break;
+                while (!triggers.empty() && triggers.begin()->first <= timeOffset + t) {
+                    dueTriggers.push_back(*triggers.begin());
+                    triggers.erase(triggers.begin());
+                }
+            }
+
+            for (const auto &trigger : dueTriggers) {
+                pushOutput(buildOutput(std::max(trigger.first - timeOffset, 0.0), trigger.second));
+                ++triggerOutputs;
+            }
+
+            std::shared_ptr<MockVioOutput> output = buildOutput(t, 0);
+            if (output->status != previousStatus) ++trackingStatusChanges;
+            previousStatus = output->status;
+
+            if (mappingEnabled() && output->status == spectacularAI::TrackingStatus::TRACKING && t >= nextKeyFrameT) {
+                KeyFrameRequest request = { nextKeyFrameId, output->getCameraPose(0), output->angularVelocity };
+                bool accepted = false;
+                {
+                    // Like a real mapper under load, skip keyframe candidates while it is behind
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (keyFrameRequests.size() < MAX_PENDING_KEY_FRAMES) {
+                        keyFrameRequests.push_back(request);
+                        accepted = true;
+                    }
+                }
+                if (accepted) {
+                    ++nextKeyFrameId;
+                    keyFrameReady.notify_one();
+                }
+                nextKeyFrameT = t + keyFrameInterval;
+            }
+
+            pushOutput(output);
+            simulatedSeconds = t;
+        }
+    }
+
+    std::shared_ptr<spectacularAI::mapping::KeyFrame> buildKeyFrame(const KeyFrameRequest &request, std::mt19937 &rng) {
+        auto frame = std::make_shared<spectacularAI::mapping::Frame>();
+        frame->cameraPose = request.cameraPose;
+        frame->depthScale = 0;
+        if (config.imageWidth > 0 && config.imageHeight > 0) {
+            std::vector<std::uint8_t> pixels((size_t)config.imageWidth * config.imageHeight);
+            for (int y = 0; y < config.imageHeight; ++y) {
+                for (int x = 0; x < config.imageWidth; ++x) {
+                    pixels[(size_t)y * config.imageWidth + x] = (std::uint8_t)((x ^ y) + request.id);
+                }
+            }
+            frame->image = spectacularAI::Image::create(
+                config.imageWidth, config.imageHeight, spectacularAI::ColorFormat::GRAY, pixels.data());
+        }
+
+        auto frameSet = std::make_shared<spectacularAI::mapping::FrameSet>();
+        frameSet->primaryFrame = frame;
+
+        // Points scattered in the camera frustum, normals roughly towards the camera
+        const int n = std::max(config.pointsPerKeyFrame, 0);
+        std::uniform_real_distribution<float> unit(-1, 1);
+        std::uniform_real_distribution<float> depth(1, 8);
+        std::vector<spectacularAI::Vector3f> positions(n);
+        std::vector<spectacularAI::Vector3f> normals(config.pointNormals ? n : 0);
+        std::vector<std::uint8_t> rgb(config.pointColors ? 3 * n : 0);
+        for (int i = 0; i < n; ++i) {
+            float z = depth(rng);
+            spectacularAI::Vector3f p = { 0.8f * unit(rng) * z, 0.5f * unit(rng) * z, z };
+            positions[i] = p;
+            if (config.pointNormals) {
+                spectacularAI::Vector3f d = { -p.x + 0.2f * unit(rng) * z, -p.y + 0.2f * unit(rng) * z, -p.z };
+                float length = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+                normals[i] = { d.x / length, d.y / length, d.z / length };
+            }
+            if (config.pointColors) {
+                rgb[3 * i] = (std::uint8_t)(255.0f * (z - 1) / 7);
+                rgb[3 * i + 1] = (std::uint8_t)(127.5f * (1 + p.y / z * 2));
+                rgb[3 * i + 2] = (std::uint8_t)(request.id * 37);
+            }
+        }
+
+        auto keyFrame = std::make_shared<spectacularAI::mapping::KeyFrame>();
+        keyFrame->id = request.id;
+        keyFrame->frameSet = frameSet;
+        keyFrame->pointCloud = spectacularAI::mapping::PointCloud::fromData(positions, normals, rgb);
+        keyFrame->angularVelocity = request.angularVelocity;
+        points += n;
+        return keyFrame;
+    }
+
+    // Call from the mapper thread or after it has been joined
+    std::shared_ptr<spectacularAI::mapping::Map> buildMap() const {
+        auto map = std::make_shared<spectacularAI::mapping::Map>();
+        map->keyFrames = keyFrames;
+        return map;
+    }
+
+    void map() {
+        std::mt19937 rng(config.seed + 1);
+        while (true) {
+            KeyFrameRequest request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                keyFrameReady.wait(lock, [this]() { return !keyFrameRequests.empty() || shouldQuit; });
+                if (shouldQuit) break;
+                request = keyFrameRequests.front();
+                keyFrameRequests.pop_front();
+            }
+
+            keyFrames[request.id] = buildKeyFrame(request, rng);
+            ++keyFramesCreated;
+            auto output = std::make_shared<spectacularAI::mapping::MapperOutput>();
+            output->updatedKeyFrames.push_back(request.id);
+            // Removed keyframes are listed as updated but are missing from the map
+            while (config.maxKeyFrames > 0 && (int32_t)keyFrames.size() > config.maxKeyFrames) {
+                output->updatedKeyFrames.push_back(keyFrames.begin()->first);
+                keyFrames.erase(keyFrames.begin());
+            }
+            output->map = buildMap();
+            output->finalMap = false;
+            onMapperOutput(output);
+            ++mapperOutputs;
+        }
+    }
+
+    const MockBackendConfigWrapper config;
+    const std::function<void(spectacularAI::mapping::MapperOutputPtr)> onMapperOutput;
+    const std::shared_ptr<const MockRig> rig;
+    const Clock::time_point wallStart;
+    const double timeOffset; // monotonic seconds at start, output time = timeOffset + simulated time
+    std::mt19937 random; // generator thread only
+
+    mutable std::mutex mutex;
+    std::condition_variable outputReady;
+    std::condition_variable spaceAvailable; // also wakes the real time generator on quit
+    std::condition_variable keyFrameReady;
+    bool shouldQuit = false;
+    std::deque<spectacularAI::VioOutputPtr> outputs;
+    std::multimap<double, int> triggers;
+    std::deque<KeyFrameRequest> keyFrameRequests;
+
+    // Mapper thread only
+    std::map<int64_t, std::shared_ptr<const spectacularAI::mapping::KeyFrame>> keyFrames;
+
+    std::atomic<int64_t> generated { 0 };
+    std::atomic<int64_t> triggerOutputs { 0 };
+    std::atomic<int64_t> dropped { 0 };
+    std::atomic<int32_t> trackingStatusChanges { 0 };
+    std::atomic<int64_t> keyFramesCreated { 0 };
+    std::atomic<int64_t> mapperOutputs { 0 };
+    std::atomic<int64_t> points { 0 };
+    std::atomic<int64_t> absolutePoses { 0 };
+    std::atomic<double> simulatedSeconds { 0 };
+
+    std::thread generatorThread;
+    std::thread mapperThread;
+};
+
+MockBackendConfigWrapper cap_output_rate(
+        MockBackendConfigWrapper config,
+        const spectacularAI::daiPlugin::Configuration &pipelineConfig) {
+    // Real sessions output at most once per IMU sample
+    double maxRate = std::max((double)pipelineConfig.gyroFrequencyHz, 1.0);
+    if (!(config.outputRateHz > 0) || config.outputRateHz > maxRate) config.outputRateHz = maxRate;
+    return config;
+}
+
+} // anonymous namespace
+
+MockBackend::MockBackend(
+        const MockBackendConfigWrapper &config,
+        const spectacularAI::daiPlugin::Configuration &pipelineConfig,
+        std::function<void(spectacularAI::mapping::MapperOutputPtr)> onMapperOutput) :
+    config(cap_output_rate(config, pipelineConfig)),
+    onMapperOutput(onMapperOutput)
+{}
+
+std::unique_ptr<spectacularAI::daiPlugin::Session> MockBackend::startSession() const {
+    return std::unique_ptr<spectacularAI::daiPlugin::Session>(new MockSession(config, onMapperOutput));
+}
+
+bool sai_depthai_session_get_mock_stats(
+        const spectacularAI::daiPlugin::Session* sessionHandle,
+        MockSessionStatsWrapper* stats) {
+    assert(sessionHandle);
+    assert(stats);
+    const MockSession* mock = dynamic_cast<const MockSession*>(sessionHandle);
+    if (!mock) return false;
+    *stats = mock->getStats();
+    return true;
+}
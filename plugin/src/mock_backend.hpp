@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../include/spectacularAI/unity/mock.hpp"
+
+#include <functional>
+#include <memory>
+
+/**
+ * Synthetic pipeline behind sai_depthai_pipeline_build, see mock.hpp. Not part of the C API.
+ */
+struct MockBackend {
+    MockBackend(
+        const MockBackendConfigWrapper &config,
+        const spectacularAI::daiPlugin::Configuration &pipelineConfig,
+        std::function<void(spectacularAI::mapping::MapperOutputPtr)> onMapperOutput);
+
+    std::unique_ptr<spectacularAI::daiPlugin::Session> startSession() const;
+
+private:
+    const MockBackendConfigWrapper config;
+    const std::function<void(spectacularAI::mapping::MapperOutputPtr)> onMapperOutput;
+};
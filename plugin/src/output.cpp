@@ -41,6 +41,7 @@ Matrix3dWrapper sai_vio_output_get_velocity_covariance(const VioOutputWrapper* v
 spectacularAI::CameraPose* sai_vio_output_get_camera_pose(const VioOutputWrapper* vioOutputHandle, int cameraId) {
     assert(vioOutputHandle);
     spectacularAI::CameraPose* cameraPose = new spectacularAI::CameraPose();
+    ++HandleCounter<spectacularAI::CameraPose>::live;
     *cameraPose = vioOutputHandle->getHandle()->getCameraPose(cameraId);
     return cameraPose;
 }
@@ -85,7 +86,10 @@ spectacularAI::Vector3d sai_camera_pose_get_position(const spectacularAI::Camera
 }
 
 void sai_camera_pose_release(spectacularAI::CameraPose* cameraPoseHandle) {
-    if (cameraPoseHandle) delete cameraPoseHandle;
+    if (cameraPoseHandle) {
+        delete cameraPoseHandle;
+        --HandleCounter<spectacularAI::CameraPose>::live;
+    }
 }
 
 bool sai_camera_pixel_to_ray(
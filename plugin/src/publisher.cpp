@@ -0,0 +1,118 @@
+#include "../include/spectacularAI/unity/publisher.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+struct PosePublisher {
+    explicit PosePublisher(sai_shm_writer* writer) : writer(writer) {}
+
+    ~PosePublisher() {
+        shouldQuit = true;
+        if (sessionThread.joinable()) sessionThread.join();
+        sai_shm_writer_close(writer);
+    }
+
+    void publish(const spectacularAI::VioOutput &output) {
+        sai_shm_pose pose;
+        std::memset(&pose, 0, sizeof(pose));
+        pose.time = output.pose.time;
+        pose.position[0] = output.pose.position.x;
+        pose.position[1] = output.pose.position.y;
+        pose.position[2] = output.pose.position.z;
+        pose.orientation[0] = output.pose.orientation.x;
+        pose.orientation[1] = output.pose.orientation.y;
+        pose.orientation[2] = output.pose.orientation.z;
+        pose.orientation[3] = output.pose.orientation.w;
+        pose.velocity[0] = output.velocity.x;
+        pose.velocity[1] = output.velocity.y;
+        pose.velocity[2] = output.velocity.z;
+        pose.angularVelocity[0] = output.angularVelocity.x;
+        pose.angularVelocity[1] = output.angularVelocity.y;
+        pose.angularVelocity[2] = output.angularVelocity.z;
+        pose.trackingStatus = (int32_t)output.status;
+        pose.tag = output.tag;
+
+        // The segment has a single writer, replay and session outputs may come from different threads
+        std::lock_guard<std::mutex> lock(mutex);
+        sai_shm_writer_publish(writer, &pose);
+        ++published;
+    }
+
+    void attachSession(spectacularAI::daiPlugin::Session* session, callback_t_vio_output onOutput) {
+        assert(!sessionThread.joinable());
+        sessionThread = std::thread([this, session, onOutput]() {
+            while (!shouldQuit) {
+                // Poll instead of waitForOutput so that release does not block forever
+                if (!session->hasOutput()) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(500));
+                    continue;
+                }
+                spectacularAI::VioOutputPtr output = session->getOutput();
+                if (!output) continue;
+                publish(*output);
+                if (onOutput) onOutput(new VioOutputWrapper(output));
+            }
+        });
+    }
+
+    std::atomic<int64_t> published { 0 };
+
+private:
+    sai_shm_writer* writer;
+    std::mutex mutex;
+    std::atomic<bool> shouldQuit { false };
+    std::thread sessionThread;
+};
+
+PosePublisher* sai_pose_publisher_create(
+        const char* name,
+        int32_t ringCapacity,
+        char* errorMsg) {
+    sai_shm_writer* writer = sai_shm_writer_create(name, ringCapacity > 0 ? (uint32_t)ringCapacity : 0, errorMsg);
+    if (!writer) return nullptr;
+    return new PosePublisher(writer);
+}
+
+void sai_pose_publisher_publish(
+        PosePublisher* publisherHandle,
+        const VioOutputWrapper* vioOutputHandle) {
+    assert(publisherHandle);
+    assert(vioOutputHandle);
+    publisherHandle->publish(*vioOutputHandle->getHandle());
+}
+
+void sai_pose_publisher_attach_replay(
+        PosePublisher* publisherHandle,
+        spectacularAI::Replay* replayHandle,
+        callback_t_vio_output onOutput) {
+    assert(publisherHandle);
+    assert(replayHandle);
+    replayHandle->setOutputCallback(
+        [publisherHandle, onOutput](const spectacularAI::VioOutputPtr vioOutput) {
+            publisherHandle->publish(*vioOutput);
+            if (onOutput) onOutput(new VioOutputWrapper(vioOutput));
+        }
+    );
+}
+
+void sai_pose_publisher_attach_session(
+        PosePublisher* publisherHandle,
+        spectacularAI::daiPlugin::Session* sessionHandle,
+        callback_t_vio_output onOutput) {
+    assert(publisherHandle);
+    assert(sessionHandle);
+    publisherHandle->attachSession(sessionHandle, onOutput);
+}
+
+int64_t sai_pose_publisher_get_published_count(PosePublisher* publisherHandle) {
+    assert(publisherHandle);
+    return publisherHandle->published;
+}
+
+void sai_pose_publisher_release(PosePublisher* publisherHandle) {
+    if (publisherHandle) delete publisherHandle;
+}
@@ -0,0 +1,263 @@
+#include "../include/spectacularAI/unity/render.hpp"
+#include "image_rows.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct RenderItem {
+    int64_t keyFrameId = 0;
+    uint64_t generation = 0;
+    bool removed = false;
+    bool hasGeometry = false;
+    spectacularAI::Pose pose;
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<std::uint8_t> colors;
+    std::vector<std::uint32_t> indices;
+    double preparationMs = 0;
+
+    int64_t bytes() const {
+        return (int64_t)(positions.size() * sizeof(float) + normals.size() * sizeof(float)
+            + colors.size() + indices.size() * sizeof(std::uint32_t));
+    }
+};
+
+namespace {
+
+bool get_key_frame_pose(const spectacularAI::mapping::KeyFrame &keyFrame, spectacularAI::Pose &pose) {
+    if (!keyFrame.frameSet || !keyFrame.frameSet->primaryFrame) return false;
+    pose = keyFrame.frameSet->primaryFrame->cameraPose.pose;
+    return true;
+}
+
+void prepare(const spectacularAI::mapping::PointCloud* pointCloud, RenderItem &item) {
+    auto start = std::chrono::steady_clock::now();
+    item.hasGeometry = true;
+    const size_t n = pointCloud ? pointCloud->size() : 0;
+    if (n > 0) {
+        // Same conversion as Utility.TransformCameraPointToUnity
+        const spectacularAI::Vector3f* positions = pointCloud->getPositionData();
+        item.positions.resize(3 * n);
+        for (size_t i = 0; i < n; ++i) {
+            item.positions[3 * i + 0] = positions[i].x;
+            item.positions[3 * i + 1] = -positions[i].y;
+            item.positions[3 * i + 2] = positions[i].z;
+        }
+
+        if (pointCloud->hasNormals()) {
+            const spectacularAI::Vector3f* normals = pointCloud->getNormalData();
+            item.normals.resize(3 * n);
+            for (size_t i = 0; i < n; ++i) {
+                item.normals[3 * i + 0] = normals[i].x;
+                item.normals[3 * i + 1] = -normals[i].y;
+                item.normals[3 * i + 2] = normals[i].z;
+            }
+        }
+
+        if (pointCloud->hasColors()) {
+            item.colors.resize(4 * n);
+            saiInternal::rgb_to_rgba_row(pointCloud->getRGB24Data(), item.colors.data(), (int)n);
+        }
+
+        item.indices.resize(n);
+        for (size_t i = 0; i < n; ++i) item.indices[i] = (std::uint32_t)i;
+    }
+    item.preparationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+struct RenderQueue {
+    explicit RenderQueue(int threadCount) : pool(std::max(1, threadCount)) {}
+
+    ~RenderQueue() {
+        // Wait for the workers, they reference this object
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return pendingJobs == 0; });
+    }
+
+    void push(const spectacularAI::mapping::MapperOutput &output) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int64_t keyFrameId : output.updatedKeyFrames) {
+            KeyFrameState &state = keyFrames[keyFrameId];
+            std::shared_ptr<const spectacularAI::mapping::KeyFrame> keyFrame;
+            if (output.map) {
+                auto it = output.map->keyFrames.find(keyFrameId);
+                if (it != output.map->keyFrames.end()) keyFrame = it->second;
+            }
+            spectacularAI::Pose pose;
+            if (!keyFrame || !get_key_frame_pose(*keyFrame, pose)) {
+                removeKeyFrame(keyFrameId, state);
+                continue;
+            }
+
+            if (state.removed) {
+                // Re-added before its removal was pulled, the queued removal item is now stale
+                state.removed = false;
+                state.seen = false;
+                ++state.generation;
+            }
+
+            state.pose = pose;
+            const std::shared_ptr<spectacularAI::mapping::PointCloud> &pointCloud = keyFrame->pointCloud;
+            if (state.seen && pointCloud == state.pointCloud) {
+                // Only the pose changed. In-flight geometry picks up the latest pose when pulled.
+                if (state.inFlight == 0) {
+                    std::unique_ptr<RenderItem> item(new RenderItem());
+                    item->keyFrameId = keyFrameId;
+                    item->generation = state.generation;
+                    ready.push_back(std::move(item));
+                    ++state.inFlight;
+                }
+                continue;
+            }
+
+            state.seen = true;
+            state.pointCloud = pointCloud;
+            uint64_t generation = ++state.generation;
+            ++state.inFlight;
+            ++pendingJobs;
+            pool.submit([this, keyFrameId, generation, pointCloud]() {
+                std::unique_ptr<RenderItem> item(new RenderItem());
+                item->keyFrameId = keyFrameId;
+                item->generation = generation;
+                prepare(pointCloud.get(), *item);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                ++preparedItems;
+                preparationMsSum += item->preparationMs;
+                maxPreparationMs = std::max(maxPreparationMs, item->preparationMs);
+                readyBytes += item->bytes();
+                ready.push_back(std::move(item));
+                if (--pendingJobs == 0) idle.notify_all();
+            });
+        }
+    }
+
+    RenderItem* tryPop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!ready.empty()) {
+            std::unique_ptr<RenderItem> item = std::move(ready.front());
+            ready.pop_front();
+            readyBytes -= item->bytes();
+
+            KeyFrameState &state = keyFrames.at(item->keyFrameId);
+            --state.inFlight;
+            bool stale = item->generation < state.generation;
+            item->removed = state.removed;
+            item->pose = state.pose;
+            if (state.removed && state.inFlight == 0) keyFrames.erase(item->keyFrameId);
+            if (stale) {
+                ++staleItems;
+                continue;
+            }
+            return item.release();
+        }
+        return nullptr;
+    }
+
+    RenderQueueStatsWrapper stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        RenderQueueStatsWrapper s;
+        s.pendingJobs = pendingJobs;
+        s.readyItems = (int32_t)ready.size();
+        s.readyBytes = readyBytes;
+        s.preparedItems = preparedItems;
+        s.staleItems = staleItems;
+        s.meanPreparationMs = preparedItems > 0 ? preparationMsSum / preparedItems : 0.0;
+        s.maxPreparationMs = maxPreparationMs;
+        return s;
+    }
+
+private:
+    struct KeyFrameState {
+        uint64_t generation = 0; // bumped when the geometry changes, older items are stale
+        int inFlight = 0; // items queued for workers or waiting to be pulled
+        bool seen = false;
+        bool removed = false;
+        spectacularAI::Pose pose;
+        std::shared_ptr<spectacularAI::mapping::PointCloud> pointCloud;
+    };
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::unordered_map<int64_t, KeyFrameState> keyFrames;
+    std::deque<std::unique_ptr<RenderItem>> ready;
+    int pendingJobs = 0;
+    int64_t readyBytes = 0;
+    int64_t preparedItems = 0;
+    int64_t staleItems = 0;
+    double preparationMsSum = 0;
+    double maxPreparationMs = 0;
+    ThreadPool pool; // last, so that workers are joined before the rest is destroyed
+
+    void removeKeyFrame(int64_t keyFrameId, KeyFrameState &state) {
+        if (!state.seen || state.removed) {
+            if (state.inFlight == 0) keyFrames.erase(keyFrameId);
+            return;
+        }
+        state.removed = true;
+        state.pointCloud.reset();
+        std::unique_ptr<RenderItem> item(new RenderItem());
+        item->keyFrameId = keyFrameId;
+        item->generation = ++state.generation;
+        ready.push_back(std::move(item));
+        ++state.inFlight;
+    }
+};
+
+RenderQueue* sai_render_queue_create(int32_t threadCount) {
+    return new RenderQueue(threadCount);
+}
+
+void sai_render_queue_push(
+        RenderQueue* renderQueueHandle,
+        const MapperOutputWrapper* mapperOutputHandle) {
+    assert(renderQueueHandle);
+    assert(mapperOutputHandle);
+    renderQueueHandle->push(*mapperOutputHandle->getHandle());
+}
+
+RenderItem* sai_render_queue_try_pop(RenderQueue* renderQueueHandle) {
+    assert(renderQueueHandle);
+    return renderQueueHandle->tryPop();
+}
+
+RenderQueueStatsWrapper sai_render_queue_get_stats(RenderQueue* renderQueueHandle) {
+    assert(renderQueueHandle);
+    return renderQueueHandle->stats();
+}
+
+void sai_render_queue_release(RenderQueue* renderQueueHandle) {
+    if (renderQueueHandle) delete renderQueueHandle;
+}
+
+void sai_render_item_get(const RenderItem* renderItemHandle, RenderItemWrapper* renderItem) {
+    assert(renderItemHandle);
+    assert(renderItem);
+    const RenderItem &item = *renderItemHandle;
+    RenderItemWrapper &w = *renderItem;
+    w.keyFrameId = item.keyFrameId;
+    w.removed = item.removed;
+    w.hasGeometry = item.hasGeometry;
+    w.pose = item.pose;
+    w.vertexCount = (int32_t)item.indices.size();
+    w.positions = item.positions.empty() ? nullptr : item.positions.data();
+    w.normals = item.normals.empty() ? nullptr : item.normals.data();
+    w.colors = item.colors.empty() ? nullptr : item.colors.data();
+    w.indices = item.indices.empty() ? nullptr : item.indices.data();
+    w.bytes = item.bytes();
+    w.preparationMs = item.preparationMs;
+}
+
+void sai_render_item_release(RenderItem* renderItemHandle) {
+    if (renderItemHandle) delete renderItemHandle;
+}
@@ -0,0 +1,244 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/spectacularAI/unity/shm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SAI_SHM_CACHE_LINE 64
+#define SAI_SHM_READ_TRIES 64 /* seqlock retries before a slot is reported as having no data */
+#define SAI_SHM_READ_SPINS 8 /* retries before yielding to a writer that is mid-update */
+
+typedef struct {
+    uint64_t seq; /* seqlock, odd while the writer is modifying the slot */
+    sai_shm_pose pose;
+} __attribute__((aligned(SAI_SHM_CACHE_LINE))) sai_shm_slot;
+
+typedef struct {
+    uint32_t magic; /* written last, readers refuse segments that are still being set up */
+    uint32_t version;
+    uint32_t ringCapacity;
+    uint32_t poseSize;
+    uint64_t published __attribute__((aligned(SAI_SHM_CACHE_LINE))); /* completed ring snapshots */
+    sai_shm_slot latest;
+    sai_shm_slot ring[];
+} sai_shm_segment;
+
+struct sai_shm_writer {
+    char name[256];
+    sai_shm_segment* segment;
+    size_t size;
+    uint64_t sequence;
+};
+
+struct sai_shm_reader {
+    const sai_shm_segment* segment;
+    size_t size;
+    uint64_t cursor;
+};
+
+static size_t segment_size(uint32_t ringCapacity) {
+    return sizeof(sai_shm_segment) + (size_t)ringCapacity * sizeof(sai_shm_slot);
+}
+
+static void set_error(char* errorMsg, const char* what) {
+    if (errorMsg == NULL) return;
+    snprintf(errorMsg, 1000, "%s", what);
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void slot_write(sai_shm_slot* slot, const sai_shm_pose* pose) {
+    uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&slot->pose, pose, sizeof(sai_shm_pose));
+    __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/*
+ * Returns 0 if the slot has never been written or no consistent copy could be read within
+ * SAI_SHM_READ_TRIES, e.g. because the writer process died in the middle of an update.
+ */
+static int slot_read(const sai_shm_slot* slot, sai_shm_pose* pose) {
+    for (int i = 0; i < SAI_SHM_READ_TRIES; ++i) {
+        if (i >= SAI_SHM_READ_SPINS) sched_yield();
+        uint64_t before = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (before == 0) return 0;
+        if (before & 1) continue;
+        memcpy(pose, (const void*)&slot->pose, sizeof(sai_shm_pose));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint64_t after = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+        if (before == after) return 1;
+    }
+    return 0;
+}
+
+sai_shm_writer* sai_shm_writer_create(const char* name, uint32_t ringCapacity, char* errorMsg) {
+    if (name == NULL || strlen(name) >= sizeof(((sai_shm_writer*)0)->name) || ringCapacity == 0) {
+        set_error(errorMsg, "invalid shared memory name or ring capacity");
+        return NULL;
+    }
+
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        set_error(errorMsg, "shm_open failed");
+        return NULL;
+    }
+
+    size_t size = segment_size(ringCapacity);
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        set_error(errorMsg, "ftruncate failed");
+        return NULL;
+    }
+
+    void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        shm_unlink(name);
+        set_error(errorMsg, "mmap failed");
+        return NULL;
+    }
+
+    sai_shm_writer* writer = (sai_shm_writer*)calloc(1, sizeof(sai_shm_writer));
+    if (writer == NULL) {
+        munmap(ptr, size);
+        shm_unlink(name);
+        set_error(errorMsg, "out of memory");
+        return NULL;
+    }
+    strcpy(writer->name, name);
+    writer->segment = (sai_shm_segment*)ptr;
+    writer->size = size;
+    writer->segment->version = SAI_SHM_VERSION;
+    writer->segment->ringCapacity = ringCapacity;
+    writer->segment->poseSize = (uint32_t)sizeof(sai_shm_pose);
+    __atomic_store_n(&writer->segment->magic, SAI_SHM_MAGIC, __ATOMIC_RELEASE);
+    return writer;
+}
+
+void sai_shm_writer_publish(sai_shm_writer* writer, const sai_shm_pose* pose) {
+    sai_shm_segment* segment = writer->segment;
+    sai_shm_pose snapshot = *pose;
+    snapshot.sequence = writer->sequence;
+    snapshot.publishTime = monotonic_seconds();
+
+    slot_write(&segment->latest, &snapshot);
+    slot_write(&segment->ring[writer->sequence % segment->ringCapacity], &snapshot);
+    ++writer->sequence;
+    __atomic_store_n(&segment->published, writer->sequence, __ATOMIC_RELEASE);
+}
+
+void sai_shm_writer_close(sai_shm_writer* writer) {
+    if (writer == NULL) return;
+    munmap(writer->segment, writer->size);
+    shm_unlink(writer->name);
+    free(writer);
+}
+
+sai_shm_reader* sai_shm_reader_open(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(sai_shm_segment)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) return NULL;
+
+    const sai_shm_segment* segment = (const sai_shm_segment*)ptr;
+    if (__atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) != SAI_SHM_MAGIC
+            || segment->version != SAI_SHM_VERSION
+            || segment->poseSize != sizeof(sai_shm_pose)
+            || segment_size(segment->ringCapacity) > size) {
+        munmap(ptr, size);
+        return NULL;
+    }
+
+    sai_shm_reader* reader = (sai_shm_reader*)calloc(1, sizeof(sai_shm_reader));
+    if (reader == NULL) {
+        munmap(ptr, size);
+        return NULL;
+    }
+    reader->segment = segment;
+    reader->size = size;
+    // Start from the oldest snapshot still in the ring
+    uint64_t published = __atomic_load_n(&segment->published, __ATOMIC_ACQUIRE);
+    reader->cursor = published > segment->ringCapacity ? published - segment->ringCapacity : 0;
+    return reader;
+}
+
+int sai_shm_reader_latest(sai_shm_reader* reader, sai_shm_pose* pose) {
+    return slot_read(&reader->segment->latest, pose);
+}
+
+int sai_shm_reader_next(sai_shm_reader* reader, sai_shm_pose* pose, uint64_t* dropped) {
+    const sai_shm_segment* segment = reader->segment;
+    const uint64_t capacity = segment->ringCapacity;
+    for (;;) {
+        uint64_t published = __atomic_load_n(&segment->published, __ATOMIC_ACQUIRE);
+        if (reader->cursor >= published) return 0;
+        if (published - reader->cursor > capacity) {
+            if (dropped) *dropped += published - capacity - reader->cursor;
+            reader->cursor = published - capacity;
+        }
+
+        // No data rather than waiting on a slot whose writer may be gone
+        if (!slot_read(&segment->ring[reader->cursor % capacity], pose)) return 0;
+        if (pose->sequence == reader->cursor) {
+            ++reader->cursor;
+            return 1;
+        }
+        // Overwritten while reading, catch up on the next iteration
+    }
+}
+
+uint64_t sai_shm_reader_published_count(sai_shm_reader* reader) {
+    return __atomic_load_n(&reader->segment->published, __ATOMIC_ACQUIRE);
+}
+
+void sai_shm_reader_close(sai_shm_reader* reader) {
+    if (reader == NULL) return;
+    munmap((void*)reader->segment, reader->size);
+    free(reader);
+}
+
+#else // _WIN32
+
+sai_shm_writer* sai_shm_writer_create(const char* name, uint32_t ringCapacity, char* errorMsg) {
+    (void)name; (void)ringCapacity;
+    if (errorMsg != NULL) strncpy(errorMsg, "POSIX shared memory is not supported on this platform", 1000 - 1);
+    return NULL;
+}
+
+void sai_shm_writer_publish(sai_shm_writer* writer, const sai_shm_pose* pose) { (void)writer; (void)pose; }
+void sai_shm_writer_close(sai_shm_writer* writer) { (void)writer; }
+sai_shm_reader* sai_shm_reader_open(const char* name) { (void)name; return NULL; }
+int sai_shm_reader_latest(sai_shm_reader* reader, sai_shm_pose* pose) { (void)reader; (void)pose; return 0; }
+int sai_shm_reader_next(sai_shm_reader* reader, sai_shm_pose* pose, uint64_t* dropped) { (void)reader; (void)pose; (void)dropped; return 0; }
+uint64_t sai_shm_reader_published_count(sai_shm_reader* reader) { (void)reader; return 0; }
+void sai_shm_reader_close(sai_shm_reader* reader) { (void)reader; }
+
+#endif
@@ -0,0 +1,75 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(int threadCount) {
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shouldQuit = true;
+    }
+    cv.notify_all();
+    for (std::thread &t : threads) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+void ThreadPool::parallelFor(int n, int minChunk, const std::function<void(int, int)> &fn) {
+    if (n <= 0) return;
+    int chunks = std::min(size() + 1, std::max(1, n / std::max(1, minChunk)));
+    if (chunks <= 1) {
+        fn(0, n);
+        return;
+    }
+
+    int chunkSize = (n + chunks - 1) / chunks;
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    int remaining = chunks - 1;
+
+    for (int c = 1; c < chunks; ++c) {
+        int begin = c * chunkSize;
+        int end = std::min(n, begin + chunkSize);
+        submit([&, begin, end]() {
+            if (begin < end) fn(begin, end);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) doneCv.notify_one();
+        });
+    }
+
+    fn(0, std::min(n, chunkSize));
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&]() { return remaining == 0; });
+}
+
+ThreadPool &ThreadPool::shared() {
+    static ThreadPool pool(std::max(1, std::min(4, (int)std::thread::hardware_concurrency() - 1)));
+    return pool;
+}
+
+void ThreadPool::work() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this]() { return shouldQuit || !tasks.empty(); });
+            if (shouldQuit && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Small fixed-size thread pool for the native helpers (image conversion, render
+ * buffer preparation, ...). Not part of the C API.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    /**
+     * Calls fn(begin, end) on disjoint ranges covering [0, n), each at least minChunk long
+     * (except possibly the last). The calling thread takes part. Blocks until all are done.
+     */
+    void parallelFor(int n, int minChunk, const std::function<void(int, int)> &fn);
+
+    int size() const { return (int)threads.size(); }
+
+    /** Process-wide pool with min(4, hardware threads - 1) workers */
+    static ThreadPool &shared();
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool shouldQuit = false;
+
+    void work();
+};
@@ -0,0 +1,817 @@
+#include "../include/spectacularAI/unity/tiles.hpp"
+#include "compact_points.hpp"
+#include "image_rows.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using KeyFramePtr = std::shared_ptr<const spectacularAI::mapping::KeyFrame>;
+
+struct KeyFrameRecord {
+    int64_t id = 0;
+    spectacularAI::Pose pose; // camera->world
+    // Points in SDK world coordinates, either full precision or compact (see compact.hpp)
+    bool compact = false;
+    std::vector<float> positions; // 3 per point
+    std::vector<std::uint8_t> colors; // RGB24, empty if the point cloud has no colors
+    saiInternal::CompactPoints points;
+
+    int32_t pointCount() const {
+        return (int32_t)(compact ? points.size() : positions.size() / 3);
+    }
+
+    int64_t bytes() const {
+        return (int64_t)sizeof(KeyFrameRecord)
+            + (compact ? points.bytes() : (int64_t)(positions.size() * sizeof(float) + colors.size()));
+    }
+
+    // All points as xyz floats and RGBA32 (white if there are no colors), either may be null
+    void decode(float* xyz, std::uint8_t* rgba) const {
+        const size_t n = (size_t)pointCount();
+        if (xyz) {
+            if (compact) saiInternal::decode_positions(points.positions.data(), n, points.box, xyz);
+            else std::memcpy(xyz, positions.data(), positions.size() * sizeof(float));
+        }
+        if (rgba) {
+            if (compact && !points.colors.empty()) saiInternal::decode_rgb565_to_rgba(points.colors.data(), n, rgba);
+            else if (!compact && !colors.empty()) saiInternal::rgb_to_rgba_row(colors.data(), rgba, (int)n);
+            else std::memset(rgba, 0xff, 4 * n);
+        }
+    }
+};
+
+struct Tile {
+    int32_t x = 0;
+    int32_t y = 0;
+    bool resident = true;
+    bool dirty = false;
+    bool prefetched = false; // paged in ahead of the camera, not yet within the active radius
+    std::vector<KeyFrameRecord> records; // empty when paged out
+    int32_t keyFrameCount = 0;
+    int32_t pointCount = 0;
+    int64_t bytes = 0; // in memory, kept as an estimate while paged out
+    int64_t fileOffset = -1;
+    int64_t fileSize = 0;
+    int64_t fileCapacity = 0;
+    uint64_t lastUsed = 0;
+};
+
+struct IndexEntry {
+    int64_t tile;
+    spectacularAI::Pose pose;
+};
+
+// Updated keyframes of one mapper output, null for removed ones
+using IngestJob = std::vector<std::pair<int64_t, KeyFramePtr>>;
+
+enum class LoadReason { ACTIVE, PREFETCH, DEMAND };
+
+// Reused page file slots are split if at least this much would be left over
+constexpr int64_t MIN_FREE_SLOT_BYTES = 4096;
+
+int64_t tile_key(int32_t x, int32_t y) {
+    return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y);
+}
+
+template<typename T>
+void put(std::vector<std::uint8_t> &buf, const T &value) {
+    const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+void put_bytes(std::vector<std::uint8_t> &buf, const void* data, size_t size) {
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    buf.insert(buf.end(), p, p + size);
+}
+
+struct BlobReader {
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+    bool ok = true;
+
+    void bytes(void* dst, size_t size) {
+        if (!ok || (size_t)(end - p) < size) {
+            ok = false;
+            return;
+        }
+        std::memcpy(dst, p, size);
+        p += size;
+    }
+
+    template<typename T>
+    T get() {
+        T value = T();
+        bytes(&value, sizeof(T));
+        return value;
+    }
+};
+
+void serialize(const std::vector<KeyFrameRecord> &records, std::vector<std::uint8_t> &buf) {
+    buf.clear();
+    put(buf, (uint32_t)records.size());
+    for (const KeyFrameRecord &r : records) {
+        put(buf, r.id);
+        put(buf, r.pose);
+        put(buf, (uint32_t)r.pointCount());
+        put(buf, (std::uint8_t)(r.compact ? 1 : 0));
+        if (r.compact) {
+            put(buf, r.points.box);
+            put(buf, (std::uint8_t)(r.points.colors.empty() ? 0 : 1));
+            put_bytes(buf, r.points.positions.data(), r.points.positions.size() * sizeof(std::uint16_t));
+            put_bytes(buf, r.points.colors.data(), r.points.colors.size() * sizeof(std::uint16_t));
+        } else {
+            put(buf, (std::uint8_t)(r.colors.empty() ? 0 : 1));
+            put_bytes(buf, r.positions.data(), r.positions.size() * sizeof(float));
+            put_bytes(buf, r.colors.data(), r.colors.size());
+        }
+    }
+}
+
+bool deserialize(const std::vector<std::uint8_t> &buf, std::vector<KeyFrameRecord> &records) {
+    BlobReader reader { buf.data(), buf.data() + buf.size() };
+    uint32_t count = reader.get<uint32_t>();
+    records.clear();
+    records.reserve(count);
+    for (uint32_t i = 0; i < count && reader.ok; ++i) {
+        KeyFrameRecord r;
+        r.id = reader.get<int64_t>();
+        r.pose = reader.get<spectacularAI::Pose>();
+        uint32_t n = reader.get<uint32_t>();
+        r.compact = reader.get<std::uint8_t>() != 0;
+        if (r.compact) r.points.box = reader.get<saiInternal::QuantizationBox>();
+        bool hasColors = reader.get<std::uint8_t>() != 0;
+        if (!reader.ok || (size_t)n * 3 * sizeof(std::uint16_t) > buf.size()) return false;
+        if (r.compact) {
+            r.points.positions.resize(3 * (size_t)n);
+            reader.bytes(r.points.positions.data(), r.points.positions.size() * sizeof(std::uint16_t));
+            if (hasColors) {
+                r.points.colors.resize(n);
+                reader.bytes(r.points.colors.data(), r.points.colors.size() * sizeof(std::uint16_t));
+            }
+        } else {
+            r.positions.resize(3 * (size_t)n);
+            reader.bytes(r.positions.data(), r.positions.size() * sizeof(float));
+            if (hasColors) {
+                r.colors.resize(3 * (size_t)n);
+                reader.bytes(r.colors.data(), r.colors.size());
+            }
+        }
+        records.push_back(std::move(r));
+    }
+    return reader.ok;
+}
+
+bool file_seek(std::FILE* file, int64_t offset) {
+#ifdef _MSC_VER
+    return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+bool make_record(int64_t id, const spectacularAI::mapping::KeyFrame &keyFrame, bool compact, KeyFrameRecord &record) {
+    if (!keyFrame.frameSet || !keyFrame.frameSet->primaryFrame) return false;
+    record.id = id;
+    record.pose = keyFrame.frameSet->primaryFrame->cameraPose.pose;
+    const spectacularAI::mapping::PointCloud* pointCloud = keyFrame.pointCloud.get();
+    const size_t n = pointCloud ? pointCloud->size() : 0;
+    if (n == 0) return true;
+
+    const spectacularAI::Matrix4d m = record.pose.asMatrix();
+    const spectacularAI::Vector3f* positions = pointCloud->getPositionData();
+    record.positions.resize(3 * n);
+    for (size_t i = 0; i < n; ++i) {
+        const spectacularAI::Vector3f &p = positions[i];
+        for (int row = 0; row < 3; ++row) {
+            record.positions[3 * i + row] = (float)(m[row][0] * p.x + m[row][1] * p.y + m[row][2] * p.z + m[row][3]);
+        }
+    }
+    const std::uint8_t* rgb = pointCloud->hasColors() ? pointCloud->getRGB24Data() : nullptr;
+    if (compact) {
+        // Quantised over the keyframe's world-frame bounding box
+        record.compact = true;
+        record.points.encode(record.positions.data(), nullptr, rgb, n, 0);
+        std::vector<float>().swap(record.positions);
+    } else if (rgb) {
+        record.colors.assign(rgb, rgb + 3 * n);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+struct TileStore {
+    TileStore(const TileStoreConfigWrapper &config, std::FILE* file) :
+        pageFilePath(config.pageFilePath),
+        tileSize(config.tileSize),
+        activeRadius(std::max(0.0, config.activeRadius)),
+        prefetchSeconds(std::max(0.0, config.prefetchSeconds)),
+        memoryCapBytes(config.memoryCapBytes),
+        compactPoints(config.compactPoints),
+        file(file)
+    {
+        worker = std::thread([this]() { run(); });
+    }
+
+    ~TileStore() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shouldQuit = true;
+        }
+        wake.notify_all();
+        worker.join();
+        {
+            // Callers woken by the last drained tasks may still be returning
+            std::unique_lock<std::mutex> lock(mutex);
+            tasksDone.wait(lock, [this]() { return waitingCallers == 0; });
+        }
+        std::fclose(file);
+        std::remove(pageFilePath.c_str());
+    }
+
+    void ingest(const spectacularAI::mapping::MapperOutput &output) {
+        IngestJob job;
+        job.reserve(output.updatedKeyFrames.size());
+        for (int64_t keyFrameId : output.updatedKeyFrames) {
+            KeyFramePtr keyFrame;
+            if (output.map) {
+                auto it = output.map->keyFrames.find(keyFrameId);
+                if (it != output.map->keyFrames.end()) keyFrame = it->second;
+            }
+            job.emplace_back(keyFrameId, std::move(keyFrame));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+        ++pendingJobs;
+        wake.notify_all();
+    }
+
+    void updatePosition(const spectacularAI::Vector3d &p, const spectacularAI::Vector3d &v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        position = p;
+        velocity = v;
+        hasPosition = true;
+        positionChanged = true;
+        wake.notify_all();
+    }
+
+    // Run on the worker after queued jobs have been applied, blocks until done. Tasks queued
+    // before shutdown are still run, returns false without running it once shutdown began.
+    bool runOnWorker(std::function<void()> task) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (shouldQuit) return false;
+        tasks.push_back(std::move(task));
+        const uint64_t ticket = ++tasksRequested;
+        wake.notify_all();
+        ++waitingCallers;
+        tasksDone.wait(lock, [this, ticket]() { return tasksCompleted >= ticket; });
+        if (--waitingCallers == 0) tasksDone.notify_all();
+        return true;
+    }
+
+    void flush() {
+        runOnWorker([this]() { writeDirty(); });
+    }
+
+    bool exportPly(const char* path, std::string &error) {
+        bool ok = false;
+        if (!runOnWorker([&]() { ok = writePly(path, error); })) error = "the store is shutting down";
+        return ok;
+    }
+
+    int32_t getTiles(const TileInfoWrapper** tilesHandle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tileInfos.clear();
+        for (const auto &it : tiles) {
+            const Tile &t = it.second;
+            TileInfoWrapper info;
+            info.x = t.x;
+            info.y = t.y;
+            info.resident = t.resident;
+            info.dirty = t.dirty;
+            info.keyFrameCount = t.keyFrameCount;
+            info.pointCount = t.pointCount;
+            info.bytes = t.bytes;
+            tileInfos.push_back(info);
+        }
+        *tilesHandle = tileInfos.empty() ? nullptr : tileInfos.data();
+        return (int32_t)tileInfos.size();
+    }
+
+    int32_t copyTilePoints(int32_t x, int32_t y, float* positions, std::uint8_t* colors, int32_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = tiles.find(tile_key(x, y));
+        if (it == tiles.end() || !it->second.resident) return -1;
+        const Tile &t = it->second;
+        int32_t copied = 0;
+        std::vector<float> partialPositions;
+        std::vector<std::uint8_t> partialColors;
+        for (const KeyFrameRecord &r : t.records) {
+            const int32_t n = std::min(r.pointCount(), capacity - copied);
+            if (n <= 0) break;
+            float* dstPositions = positions ? positions + 3 * (size_t)copied : nullptr;
+            std::uint8_t* dstColors = colors ? colors + 4 * (size_t)copied : nullptr;
+            if (n == r.pointCount()) {
+                r.decode(dstPositions, dstColors);
+            } else {
+                // Last record does not fit, decode it aside and copy what does
+                partialPositions.resize(3 * (size_t)r.pointCount());
+                partialColors.resize(4 * (size_t)r.pointCount());
+                r.decode(partialPositions.data(), partialColors.data());
+                if (dstPositions) std::memcpy(dstPositions, partialPositions.data(), 3 * (size_t)n * sizeof(float));
+                if (dstColors) std::memcpy(dstColors, partialColors.data(), 4 * (size_t)n);
+            }
+            if (dstPositions) {
+                // Same conversion as Utility.TransformWorldPointToUnity
+                for (int32_t i = 0; i < n; ++i) std::swap(dstPositions[3 * i + 1], dstPositions[3 * i + 2]);
+            }
+            copied += n;
+        }
+        return t.pointCount;
+    }
+
+    bool getKeyFramePose(int64_t keyFrameId, spectacularAI::Pose &pose) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(keyFrameId);
+        if (it == index.end()) return false;
+        pose = it->second.pose;
+        return true;
+    }
+
+    TileStoreStatsWrapper stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        TileStoreStatsWrapper s = counters;
+        s.tiles = (int32_t)tiles.size();
+        s.residentTiles = 0;
+        s.dirtyTiles = 0;
+        s.points = 0;
+        for (const auto &it : tiles) {
+            if (it.second.resident) ++s.residentTiles;
+            if (it.second.dirty) ++s.dirtyTiles;
+            s.points += it.second.pointCount;
+        }
+        s.pendingJobs = pendingJobs;
+        s.keyFrames = (int64_t)index.size();
+        s.residentBytes = residentBytes;
+        s.memoryCapBytes = memoryCapBytes;
+        s.pageFileBytes = fileEnd;
+        s.pageFileDeadBytes = deadBytes;
+        s.meanLoadMs = counters.loads > 0 ? loadMsSum / counters.loads : 0.0;
+        return s;
+    }
+
+private:
+    const std::string pageFilePath;
+    const double tileSize;
+    const double activeRadius;
+    const double prefetchSeconds;
+    const int64_t memoryCapBytes;
+    const bool compactPoints;
+    std::FILE* file;
+
+    // Protects everything below. Only the worker modifies tiles, index and the page file,
+    // it reads them without locking and does I/O with the mutex released.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable tasksDone;
+    std::deque<std::function<void()>> tasks;
+    std::deque<IngestJob> jobs;
+    int32_t pendingJobs = 0;
+    spectacularAI::Vector3d position {0, 0, 0};
+    spectacularAI::Vector3d velocity {0, 0, 0};
+    bool hasPosition = false;
+    bool positionChanged = false;
+    bool shouldQuit = false;
+    uint64_t tasksRequested = 0;
+    uint64_t tasksCompleted = 0;
+    int waitingCallers = 0; // blocked in runOnWorker
+
+    std::unordered_map<int64_t, Tile> tiles;
+    std::unordered_map<int64_t, IndexEntry> index;
+    std::vector<TileInfoWrapper> tileInfos;
+    int64_t residentBytes = 0;
+    int64_t fileEnd = 0;
+    int64_t deadBytes = 0; // in free page file slots
+    TileStoreStatsWrapper counters = {};
+    double loadMsSum = 0;
+
+    // Worker only
+    std::unordered_set<int64_t> activeTiles;
+    std::unordered_set<int64_t> aheadTiles;
+    uint64_t tick = 0;
+    std::vector<std::uint8_t> blob;
+    std::multimap<int64_t, int64_t> freeSlots; // capacity -> offset of abandoned page file slots
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() {
+                return shouldQuit || !jobs.empty() || positionChanged || !tasks.empty();
+            });
+            // Drain tasks first, their callers are blocked waiting for them
+            if (shouldQuit && tasks.empty()) break;
+
+            std::deque<IngestJob> batch;
+            batch.swap(jobs);
+            positionChanged = false;
+            std::deque<std::function<void()>> batchTasks;
+            batchTasks.swap(tasks);
+            const bool havePosition = hasPosition;
+            const spectacularAI::Vector3d p = position;
+            const spectacularAI::Vector3d v = velocity;
+            lock.unlock();
+
+            for (const IngestJob &job : batch) apply(job);
+            if (havePosition) page(p, v);
+            enforceCap(0);
+            for (const auto &task : batchTasks) task();
+
+            lock.lock();
+            pendingJobs -= (int32_t)batch.size();
+            if (!batchTasks.empty()) {
+                tasksCompleted += batchTasks.size();
+                tasksDone.notify_all();
+            }
+        }
+    }
+
+    int64_t tileOf(const spectacularAI::Vector3d &p) const {
+        return tile_key((int32_t)std::floor(p.x / tileSize), (int32_t)std::floor(p.y / tileSize));
+    }
+
+    void apply(const IngestJob &job) {
+        for (const auto &update : job) {
+            const int64_t keyFrameId = update.first;
+            KeyFrameRecord record;
+            const bool hasRecord = update.second && make_record(keyFrameId, *update.second, compactPoints, record);
+            if (update.second && !hasRecord) continue; // no pose yet, keep the previous one
+
+            // Load both tiles before changing either, so that a failed read leaves the
+            // previous record in place instead of losing the keyframe
+            Tile* target = nullptr;
+            int64_t key = 0;
+            if (hasRecord) {
+                key = tileOf(record.pose.position);
+                auto tileIt = tiles.find(key);
+                if (tileIt == tiles.end()) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    Tile &t = tiles[key];
+                    t.x = (int32_t)(key >> 32);
+                    t.y = (int32_t)(uint32_t)key;
+                    t.lastUsed = tick;
+                    tileIt = tiles.find(key);
+                }
+                target = &tileIt->second;
+            }
+            auto indexIt = index.find(keyFrameId);
+            Tile* old = indexIt != index.end() ? &tiles.at(indexIt->second.tile) : nullptr;
+            if ((target && !ensureResident(*target, LoadReason::DEMAND))
+                    || (old && !ensureResident(*old, LoadReason::DEMAND))) {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++counters.failedUpdates;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (old) {
+                for (auto it = old->records.begin(); it != old->records.end(); ++it) {
+                    if (it->id != keyFrameId) continue;
+                    changeSize(*old, -1, -it->pointCount(), -it->bytes());
+                    old->records.erase(it);
+                    break;
+                }
+                index.erase(indexIt);
+            }
+            if (!target) continue;
+
+            changeSize(*target, 1, record.pointCount(), record.bytes());
+            index[keyFrameId] = IndexEntry { key, record.pose };
+            target->records.push_back(std::move(record));
+        }
+    }
+
+    // Call with the mutex held, tile must be resident
+    void changeSize(Tile &t, int32_t keyFrames, int32_t points, int64_t bytes) {
+        t.keyFrameCount += keyFrames;
+        t.pointCount += points;
+        t.bytes += bytes;
+        t.dirty = true;
+        residentBytes += bytes;
+    }
+
+    void page(const spectacularAI::Vector3d &p, const spectacularAI::Vector3d &v) {
+        ++tick;
+        std::vector<std::pair<double, int64_t>> active;
+        std::vector<std::pair<double, int64_t>> ahead;
+        activeTiles.clear();
+        aheadTiles.clear();
+
+        // Tiles whose square is within activeRadius of the point
+        auto collect = [this](const spectacularAI::Vector3d &q, double order,
+                std::vector<std::pair<double, int64_t>> &out, std::unordered_set<int64_t> &set) {
+            const int32_t x0 = (int32_t)std::floor((q.x - activeRadius) / tileSize);
+            const int32_t x1 = (int32_t)std::floor((q.x + activeRadius) / tileSize);
+            const int32_t y0 = (int32_t)std::floor((q.y - activeRadius) / tileSize);
+            const int32_t y1 = (int32_t)std::floor((q.y + activeRadius) / tileSize);
+            for (int32_t x = x0; x <= x1; ++x) {
+                for (int32_t y = y0; y <= y1; ++y) {
+                    const int64_t key = tile_key(x, y);
+                    if (!tiles.count(key) || activeTiles.count(key) || set.count(key)) continue;
+                    const double dx = std::max({ x * tileSize - q.x, 0.0, q.x - (x + 1) * tileSize });
+                    const double dy = std::max({ y * tileSize - q.y, 0.0, q.y - (y + 1) * tileSize });
+                    const double d = std::sqrt(dx * dx + dy * dy);
+                    if (d > activeRadius) continue;
+                    set.insert(key);
+                    out.emplace_back(order + d, key);
+                }
+            }
+        };
+
+        collect(p, 0.0, active, activeTiles);
+        const double ax = v.x * prefetchSeconds;
+        const double ay = v.y * prefetchSeconds;
+        const double distance = std::sqrt(ax * ax + ay * ay);
+        const int steps = (int)std::ceil(distance / (0.5 * tileSize));
+        for (int s = 1; s <= steps; ++s) {
+            const double f = s / (double)steps;
+            const spectacularAI::Vector3d q { p.x + f * ax, p.y + f * ay, p.z };
+            collect(q, f * distance, ahead, aheadTiles);
+        }
+        std::sort(active.begin(), active.end());
+        std::sort(ahead.begin(), ahead.end());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &a : active) {
+                Tile &t = tiles.at(a.second);
+                t.lastUsed = tick;
+                if (!t.resident) ++counters.activeMisses;
+                else if (t.prefetched) ++counters.prefetchHits;
+                t.prefetched = false;
+            }
+            for (const auto &a : ahead) tiles.at(a.second).lastUsed = tick;
+        }
+
+        for (const auto &a : active) ensureResident(tiles.at(a.second), LoadReason::ACTIVE);
+        for (const auto &a : ahead) {
+            Tile &t = tiles.at(a.second);
+            if (t.resident) continue;
+            // Prefetch only into free memory, never push out closer tiles for it
+            enforceCap(t.bytes);
+            if (residentBytes + t.bytes > memoryCapBytes) break;
+            ensureResident(t, LoadReason::PREFETCH);
+        }
+    }
+
+    // Evict tiles until `incoming` more bytes fit under the cap. Tiles within the active
+    // radius are never evicted, prefetched tiles only after all others.
+    void enforceCap(int64_t incoming) {
+        if (residentBytes + incoming <= memoryCapBytes) return;
+        std::vector<std::pair<std::pair<bool, uint64_t>, int64_t>> candidates;
+        for (const auto &it : tiles) {
+            if (!it.second.resident || activeTiles.count(it.first)) continue;
+            candidates.push_back({ { aheadTiles.count(it.first) > 0, it.second.lastUsed }, it.first });
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto &c : candidates) {
+            if (residentBytes + incoming <= memoryCapBytes) break;
+            if (c.first.first && incoming > 0) break;
+            evict(tiles.at(c.second));
+        }
+    }
+
+    void evict(Tile &t) {
+        if (t.dirty && !writeTile(t)) return;
+        std::vector<KeyFrameRecord> records;
+        std::lock_guard<std::mutex> lock(mutex);
+        records.swap(t.records);
+        t.resident = false;
+        t.prefetched = false;
+        residentBytes -= t.bytes;
+        ++counters.evictions;
+    }
+
+    void writeDirty() {
+        for (auto &it : tiles) {
+            if (it.second.resident && it.second.dirty) writeTile(it.second);
+        }
+    }
+
+    bool writeTile(Tile &t) {
+        serialize(t.records, blob);
+        const int64_t size = (int64_t)blob.size();
+        // Rewrite in place if it fits or the slot is last in the file, otherwise move the tile
+        // to the smallest free slot that fits and only append if there is none
+        const bool inPlace = t.fileOffset >= 0
+            && (t.fileCapacity >= size || t.fileOffset + t.fileCapacity == fileEnd);
+        int64_t offset = inPlace ? t.fileOffset : fileEnd;
+        int64_t capacity = inPlace ? std::max(size, t.fileCapacity) : size;
+        auto slot = inPlace ? freeSlots.end() : freeSlots.lower_bound(size);
+        if (slot != freeSlots.end()) {
+            offset = slot->second;
+            capacity = slot->first;
+        }
+        if (!file_seek(file, offset) || std::fwrite(blob.data(), 1, blob.size(), file) != blob.size()) return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (slot != freeSlots.end()) {
+            freeSlots.erase(slot);
+            deadBytes -= capacity;
+            if (capacity - size >= MIN_FREE_SLOT_BYTES) {
+                freeSlots.emplace(capacity - size, offset + size);
+                deadBytes += capacity - size;
+                capacity = size;
+            }
+        }
+        if (!inPlace && t.fileOffset >= 0) {
+            freeSlots.emplace(t.fileCapacity, t.fileOffset);
+            deadBytes += t.fileCapacity;
+        }
+        fileEnd = std::max(fileEnd, offset + capacity);
+        t.fileOffset = offset;
+        t.fileCapacity = capacity;
+        t.fileSize = size;
+        t.dirty = false;
+        ++counters.writes;
+        counters.bytesWritten += size;
+        return true;
+    }
+
+    bool writePly(const char* path, std::string &error) {
+        std::FILE* out = std::fopen(path, "wb");
+        if (!out) {
+            error = std::string("failed to open ") + path;
+            return false;
+        }
+        int64_t total = 0;
+        for (const auto &it : tiles) total += it.second.pointCount;
+        std::fprintf(out,
+            "ply\nformat binary_little_endian 1.0\nelement vertex %lld\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property uchar red\nproperty uchar green\nproperty uchar blue\nend_header\n",
+            (long long)total);
+
+        // Paged out tiles are decoded straight from the page file without making them resident
+        std::vector<KeyFrameRecord> paged;
+        std::vector<float> xyz;
+        std::vector<std::uint8_t> rgba;
+        std::vector<std::uint8_t> row;
+        int64_t written = 0;
+        bool ok = true;
+        for (const auto &it : tiles) {
+            const Tile &t = it.second;
+            const std::vector<KeyFrameRecord>* records = &t.records;
+            if (!t.resident) {
+                if (!readTile(t, paged)) {
+                    ok = false;
+                    break;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.bytesRead += t.fileSize;
+                records = &paged;
+            }
+            for (const KeyFrameRecord &r : *records) {
+                const size_t n = (size_t)r.pointCount();
+                xyz.resize(3 * n);
+                rgba.resize(4 * n);
+                row.resize(15 * n);
+                r.decode(xyz.data(), rgba.data());
+                for (size_t i = 0; i < n; ++i) {
+                    std::memcpy(&row[15 * i], &xyz[3 * i], 3 * sizeof(float));
+                    std::memcpy(&row[15 * i + 12], &rgba[4 * i], 3);
+                }
+                ok = ok && std::fwrite(row.data(), 1, row.size(), out) == row.size();
+                written += (int64_t)n;
+            }
+        }
+        ok = std::fclose(out) == 0 && ok && written == total;
+        if (!ok) error = std::string("failed to write ") + path;
+        return ok;
+    }
+
+    bool readTile(const Tile &t, std::vector<KeyFrameRecord> &records) {
+        blob.resize((size_t)t.fileSize);
+        return file_seek(file, t.fileOffset)
+            && std::fread(blob.data(), 1, blob.size(), file) == blob.size()
+            && deserialize(blob, records);
+    }
+
+    bool ensureResident(Tile &t, LoadReason reason) {
+        if (t.resident) return true;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<KeyFrameRecord> records;
+        if (!readTile(t, records)) return false;
+        int64_t bytes = 0;
+        for (const KeyFrameRecord &r : records) bytes += r.bytes();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        t.records.swap(records);
+        t.resident = true;
+        t.prefetched = reason == LoadReason::PREFETCH;
+        t.bytes = bytes;
+        residentBytes += bytes;
+        ++counters.loads;
+        if (reason == LoadReason::PREFETCH) ++counters.prefetchLoads;
+        if (reason == LoadReason::DEMAND) ++counters.demandLoads;
+        counters.bytesRead += t.fileSize;
+        loadMsSum += ms;
+        counters.maxLoadMs = std::max(counters.maxLoadMs, ms);
+        return true;
+    }
+};
+
+TileStore* sai_tile_store_create(const TileStoreConfigWrapper* config, char* errorMsg) {
+    assert(config);
+    if (!config->pageFilePath || !*config->pageFilePath || !(config->tileSize > 0)) {
+        if (errorMsg) std::strncpy(errorMsg, "TileStore: page file path and a positive tile size are required", 1000 - 1);
+        return nullptr;
+    }
+    std::FILE* file = std::fopen(config->pageFilePath, "w+b");
+    if (!file) {
+        if (errorMsg) std::snprintf(errorMsg, 1000, "TileStore: failed to open page file %s", config->pageFilePath);
+        return nullptr;
+    }
+    return new TileStore(*config, file);
+}
+
+void sai_tile_store_ingest(TileStore* tileStoreHandle, const MapperOutputWrapper* mapperOutputHandle) {
+    assert(tileStoreHandle);
+    assert(mapperOutputHandle);
+    tileStoreHandle->ingest(*mapperOutputHandle->getHandle());
+}
+
+void sai_tile_store_update_position(TileStore* tileStoreHandle, const VioOutputWrapper* vioOutputHandle) {
+    assert(tileStoreHandle);
+    assert(vioOutputHandle);
+    const spectacularAI::VioOutput &output = *vioOutputHandle->getHandle();
+    tileStoreHandle->updatePosition(output.pose.position, output.velocity);
+}
+
+void sai_tile_store_flush(TileStore* tileStoreHandle) {
+    assert(tileStoreHandle);
+    tileStoreHandle->flush();
+}
+
+bool sai_tile_store_export_ply(TileStore* tileStoreHandle, const char* path, char* errorMsg) {
+    assert(tileStoreHandle);
+    assert(path);
+    std::string error;
+    if (tileStoreHandle->exportPly(path, error)) return true;
+    if (errorMsg) std::snprintf(errorMsg, 1000, "TileStore: %s", error.c_str());
+    return false;
+}
+
+int32_t sai_tile_store_get_tiles(TileStore* tileStoreHandle, const TileInfoWrapper** tilesHandle) {
+    assert(tileStoreHandle);
+    assert(tilesHandle);
+    return tileStoreHandle->getTiles(tilesHandle);
+}
+
+int32_t sai_tile_store_copy_tile_points(
+        TileStore* tileStoreHandle,
+        int32_t tileX,
+        int32_t tileY,
+        float* positions,
+        std::uint8_t* colors,
+        int32_t capacity) {
+    assert(tileStoreHandle);
+    return tileStoreHandle->copyTilePoints(tileX, tileY, positions, colors, capacity);
+}
+
+bool sai_tile_store_get_key_frame_pose(
+        TileStore* tileStoreHandle,
+        int64_t keyFrameId,
+        spectacularAI::Pose* pose) {
+    assert(tileStoreHandle);
+    assert(pose);
+    return tileStoreHandle->getKeyFramePose(keyFrameId, *pose);
+}
+
+TileStoreStatsWrapper sai_tile_store_get_stats(TileStore* tileStoreHandle) {
+    assert(tileStoreHandle);
+    return tileStoreHandle->stats();
+}
+
+void sai_tile_store_release(TileStore* tileStoreHandle) {
+    if (tileStoreHandle) delete tileStoreHandle;
+}
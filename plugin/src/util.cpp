@@ -17,6 +17,35 @@ Matrix4dWrapper matrix_to_wrapper(const spectacularAI::Matrix4d &m) {
     return w;
 }
 
+spectacularAI::Matrix4d matrix_multiply(const spectacularAI::Matrix4d &a, const spectacularAI::Matrix4d &b) {
+    spectacularAI::Matrix4d r;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            r[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j] + a[i][3] * b[3][j];
+        }
+    }
+    return r;
+}
+
+spectacularAI::Matrix4d matrix_rigid_inverse(const spectacularAI::Matrix4d &m) {
+    // [R t; 0 1]^-1 = [R^T -R^T t; 0 1]
+    spectacularAI::Matrix4d r;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) r[i][j] = m[j][i];
+        r[i][3] = -(m[0][i] * m[0][3] + m[1][i] * m[1][3] + m[2][i] * m[2][3]);
+    }
+    r[3][0] = 0; r[3][1] = 0; r[3][2] = 0; r[3][3] = 1;
+    return r;
+}
+
+spectacularAI::Vector3d matrix_transform_point(const spectacularAI::Matrix4d &m, const spectacularAI::Vector3d &p) {
+    return spectacularAI::Vector3d {
+        m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+        m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+        m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3]
+    };
+}
+
 Matrix4dWrapper sai_pose_as_matrix(spectacularAI::Vector3d position, spectacularAI::Quaternion orientation) {
     spectacularAI::Pose pose;
     pose.position = position;
@@ -28,4 +57,18 @@ spectacularAI::Pose sai_pose_from_matrix(double t, Matrix4dWrapper localToWorld)
     return spectacularAI::Pose::fromMatrix(
         t, 
         reinterpret_cast<spectacularAI::Matrix4d&>(localToWorld));
-}
\ No newline at end of file
+}
+
+HandleCountsWrapper sai_get_live_handle_counts() {
+    HandleCountsWrapper counts;
+    counts.vioOutputs = HandleCounter<const spectacularAI::VioOutput>::live;
+    counts.cameraPoses = HandleCounter<spectacularAI::CameraPose>::live;
+    counts.cameras = HandleCounter<const spectacularAI::Camera>::live;
+    counts.mapperOutputs = HandleCounter<const spectacularAI::mapping::MapperOutput>::live;
+    counts.maps = HandleCounter<const spectacularAI::mapping::Map>::live;
+    counts.keyFrames = HandleCounter<const spectacularAI::mapping::KeyFrame>::live;
+    counts.frameSets = HandleCounter<spectacularAI::mapping::FrameSet>::live;
+    counts.frames = HandleCounter<spectacularAI::mapping::Frame>::live;
+    counts.pointClouds = HandleCounter<spectacularAI::mapping::PointCloud>::live;
+    return counts;
+}
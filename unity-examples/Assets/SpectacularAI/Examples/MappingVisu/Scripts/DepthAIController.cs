@@ -17,6 +17,7 @@ namespace SpectacularAI.Examples.MappingVisu
 
         private void OnDisable()
         {
+            _mapRenderer.Dispose();
             _mapRenderer = null;
         }
 
@@ -28,6 +29,8 @@ namespace SpectacularAI.Examples.MappingVisu
                 _mapRenderer.OnMapperOutput(output);
                 output.Dispose(); // Must dispose mapper outputs
             }
+
+            _mapRenderer.Update();
         }
     }
 }
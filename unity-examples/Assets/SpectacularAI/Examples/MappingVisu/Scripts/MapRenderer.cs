@@ -3,11 +3,16 @@ using System.Collections.Generic;
 
 namespace SpectacularAI.Examples.MappingVisu
 {
-    public class MapRenderer
+    public class MapRenderer : System.IDisposable
     {
+        // Per-frame budget for uploading prepared keyframes to meshes
+        private const double DrainTimeBudgetMs = 4.0;
+        private const long DrainByteBudget = 16 * 1024 * 1024;
+
         private UnityEngine.Material _pointCloudMaterial;
         private UnityEngine.GameObject _map;
         private Dictionary<long, UnityEngine.GameObject> _keyFrames = new Dictionary<long, UnityEngine.GameObject>();
+        private RenderQueue _renderQueue = new RenderQueue();
 
         public MapRenderer(UnityEngine.Material pointCloudMaterial)
         {
@@ -15,36 +20,42 @@ namespace SpectacularAI.Examples.MappingVisu
             _map = new UnityEngine.GameObject("SLAM Map");
         }
 
-        ~MapRenderer()
+        public void Dispose()
         {
+            _renderQueue.Dispose();
             UnityEngine.GameObject.Destroy(_map);
         }
 
-        private void AddKeyFrame(KeyFrame kf)
+        private UnityEngine.GameObject AddKeyFrame(long kfId)
         {
-            UnityEngine.GameObject keyFrame = new UnityEngine.GameObject("KeyFrame" + kf.Id);
+            UnityEngine.GameObject keyFrame = new UnityEngine.GameObject("KeyFrame" + kfId);
             keyFrame.AddComponent<Common.CameraPoseRenderer>();
             keyFrame.transform.parent = _map.transform;
-            if (!kf.PointCloud.Empty)
-            {
-                UnityEngine.GameObject pointCloudRenderer = new UnityEngine.GameObject("PointCloudRenderer");
-                var rendr = pointCloudRenderer.AddComponent<PointCloudRenderer>();
-                rendr.Initialize(kf.PointCloud, _pointCloudMaterial);
-                pointCloudRenderer.transform.parent = keyFrame.transform;
-            }
-            _keyFrames.Add(kf.Id, keyFrame);
+            _keyFrames.Add(kfId, keyFrame);
+            return keyFrame;
         }
 
-        private void UpdateKeyFrame(KeyFrame kf)
+        private void UpdateKeyFrame(RenderItem item)
         {
-            if (!_keyFrames.ContainsKey(kf.Id))
+            UnityEngine.GameObject keyFrame;
+            if (!_keyFrames.TryGetValue(item.KeyFrameId, out keyFrame))
+            {
+                keyFrame = AddKeyFrame(item.KeyFrameId);
+            }
+
+            if (item.HasGeometry)
             {
-                if (kf.PointCloud == null) return;
-                AddKeyFrame(kf);
+                PointCloudRenderer rendr = keyFrame.GetComponentInChildren<PointCloudRenderer>();
+                if (rendr == null && item.VertexCount > 0)
+                {
+                    UnityEngine.GameObject pointCloudRenderer = new UnityEngine.GameObject("PointCloudRenderer");
+                    pointCloudRenderer.transform.SetParent(keyFrame.transform, false);
+                    rendr = pointCloudRenderer.AddComponent<PointCloudRenderer>();
+                }
+                if (rendr != null) rendr.Initialize(item, _pointCloudMaterial);
             }
 
-            UnityEngine.GameObject keyFrame = _keyFrames[kf.Id];
-            Pose cameraToWorld = kf.FrameSet.PrimaryFrame.CameraPose.Pose;
+            Pose cameraToWorld = item.Pose;
             keyFrame.transform.position = cameraToWorld.Position;
             keyFrame.transform.rotation = cameraToWorld.Orientation;
         }
@@ -59,21 +70,26 @@ namespace SpectacularAI.Examples.MappingVisu
             }
         }
 
+        private void OnRenderItem(RenderItem item)
+        {
+            if (item.Removed) RemoveKeyFrame(item.KeyFrameId);
+            else UpdateKeyFrame(item);
+        }
+
+        /// <summary>
+        /// Queue the updated keyframes, their buffers are prepared in the background.
+        /// </summary>
         public void OnMapperOutput(MapperOutput output)
         {
-            Map map = output.Map;
+            _renderQueue.Push(output);
+        }
 
-            foreach (long kfId in output.UpdatedKeyFrames)
-            {
-                if (map.KeyFrames.ContainsKey(kfId))
-                {
-                    UpdateKeyFrame(map.KeyFrames[kfId]);
-                }
-                else
-                {
-                    RemoveKeyFrame(kfId);
-                }
-            }
+        /// <summary>
+        /// Upload prepared keyframes, call once per frame.
+        /// </summary>
+        public void Update()
+        {
+            _renderQueue.Drain(DrainTimeBudgetMs, DrainByteBudget, OnRenderItem);
         }
     }
-}
\ No newline at end of file
+}
@@ -6,6 +6,19 @@ namespace SpectacularAI.Examples.MappingVisu
 
     public sealed class PointCloudRenderer : MonoBehaviour
     {
+        private static readonly VertexAttributeDescriptor[] PositionLayout = new[]
+        {
+            new VertexAttributeDescriptor(VertexAttribute.Position, VertexAttributeFormat.Float32, 3, 0)
+        };
+
+        private static readonly VertexAttributeDescriptor[] PositionColorLayout = new[]
+        {
+            new VertexAttributeDescriptor(VertexAttribute.Position, VertexAttributeFormat.Float32, 3, 0),
+            new VertexAttributeDescriptor(VertexAttribute.Color, VertexAttributeFormat.UNorm8, 4, 1)
+        };
+
+        private Mesh _mesh;
+
         public void Initialize(PointCloud pointCloud, Material material)
         {
             Mesh mesh = new Mesh
@@ -24,11 +37,58 @@ namespace SpectacularAI.Examples.MappingVisu
             if (pointCloud.HasColors) mesh.SetColors(pointCloud.Colors, 0, pointCloud.Size);
             mesh.UploadMeshData(true);
 
-            MeshFilter meshFilter = gameObject.AddComponent<MeshFilter>();
-            meshFilter.mesh = mesh;
+            SetMesh(mesh, material);
+        }
+
+        /// <summary>
+        /// Build the mesh from buffers prepared by RenderQueue. Only copies and uploads,
+        /// so this is cheap enough to call from Update. Replaces the previous mesh, if any.
+        /// </summary>
+        public void Initialize(RenderItem item, Material material)
+        {
+            int n = item.VertexCount;
+            float[] positions = new float[3 * n];
+            int[] indices = new int[n];
+            item.CopyPositions(positions);
+            item.CopyIndices(indices);
+
+            Mesh mesh = new Mesh();
+            mesh.SetVertexBufferParams(n, item.HasColors ? PositionColorLayout : PositionLayout);
+            mesh.SetVertexBufferData(positions, 0, 0, positions.Length, 0);
+            if (item.HasColors)
+            {
+                byte[] colors = new byte[4 * n];
+                item.CopyColors(colors);
+                mesh.SetVertexBufferData(colors, 0, 0, colors.Length, 1);
+            }
 
-            MeshRenderer meshRenderer = gameObject.AddComponent<MeshRenderer>();
+            mesh.SetIndexBufferParams(n, IndexFormat.UInt32);
+            mesh.SetIndexBufferData(indices, 0, 0, n);
+            mesh.subMeshCount = 1;
+            mesh.SetSubMesh(0, new SubMeshDescriptor(0, n, MeshTopology.Points));
+            mesh.RecalculateBounds();
+            mesh.UploadMeshData(true);
+
+            SetMesh(mesh, material);
+        }
+
+        private void SetMesh(Mesh mesh, Material material)
+        {
+            if (_mesh != null) Destroy(_mesh);
+            _mesh = mesh;
+
+            MeshFilter meshFilter = GetComponent<MeshFilter>();
+            if (meshFilter == null) meshFilter = gameObject.AddComponent<MeshFilter>();
+            meshFilter.sharedMesh = mesh;
+
+            MeshRenderer meshRenderer = GetComponent<MeshRenderer>();
+            if (meshRenderer == null) meshRenderer = gameObject.AddComponent<MeshRenderer>();
             meshRenderer.sharedMaterial = material;
         }
+
+        private void OnDestroy()
+        {
+            if (_mesh != null) Destroy(_mesh);
+        }
     }
 }
@@ -0,0 +1,194 @@
+using System;
+using System.Runtime.InteropServices;
+using SpectacularAI.Native;
+
+namespace SpectacularAI.Mapping
+{
+    /// <summary>
+    /// Anchor whose pose changed during a mapper update.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AnchorUpdate
+    {
+        /// <summary>
+        /// Anchor ID returned by AnchorSet.Add
+        /// </summary>
+        public long AnchorId;
+
+        /// <summary>
+        /// Corrected anchor->world pose
+        /// </summary>
+        public Pose Pose;
+    }
+
+    /// <summary>
+    /// World-anchored content that follows SLAM map corrections (e.g. loop closures).
+    /// Each anchor is attached to its nearest keyframe(s) and only the anchors whose
+    /// keyframes were updated are recomputed.
+    /// </summary>
+    public sealed class AnchorSet : IDisposable
+    {
+        // Native handle to the AnchorSet
+        private readonly IntPtr _handle;
+
+        // To detect redundant calls to Dispose
+        private bool _disposed = false;
+
+        /// <summary>
+        /// Initializes a new instance of the AnchorSet class.
+        /// </summary>
+        /// <param name="keyFramesPerAnchor">Number of nearest keyframes each anchor is attached to.</param>
+        /// <param name="minPositionChange">Anchors that moved less than this (meters) are not reported.</param>
+        /// <param name="minAngleChange">Anchors that rotated less than this (radians) are not reported.</param>
+        public AnchorSet(int keyFramesPerAnchor = 2, double minPositionChange = 1e-4, double minAngleChange = 1e-4)
+        {
+            _handle = ExternApi.sai_anchor_set_create(keyFramesPerAnchor, minPositionChange, minAngleChange);
+        }
+
+        /// <summary>
+        /// Releases the resources associated with the AnchorSet object.
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases unmanaged and - optionally - managed resources.
+        /// </summary>
+        private void Dispose(bool disposing)
+        {
+            if (!_disposed)
+            {
+                if (disposing)
+                {
+                    // No managed resources to release in this case
+                }
+
+                ExternApi.sai_anchor_set_release(_handle);
+
+                _disposed = true;
+            }
+        }
+
+        /// <summary>
+        /// Finalizes an instance of the AnchorSet class.
+        /// </summary>
+        ~AnchorSet()
+        {
+            Dispose(false);
+        }
+
+        /// <summary>
+        /// Number of anchors.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                CheckDisposed();
+                return ExternApi.sai_anchor_set_get_count(_handle);
+            }
+        }
+
+        /// <summary>
+        /// Add an anchor and attach it to the nearest keyframes of the given map.
+        /// </summary>
+        /// <param name="map">Current SLAM map. If null or empty, the anchor is attached on the next Update.</param>
+        /// <param name="anchorToWorld">Anchor pose in world coordinates</param>
+        /// <returns>Anchor ID</returns>
+        public long Add(Map map, Pose anchorToWorld)
+        {
+            CheckDisposed();
+            IntPtr mapHandle = map == null ? IntPtr.Zero : map.GetNativeHandle();
+            return ExternApi.sai_anchor_set_add(_handle, mapHandle, anchorToWorld);
+        }
+
+        /// <summary>
+        /// Remove an anchor.
+        /// </summary>
+        /// <returns>True if the anchor existed</returns>
+        public bool Remove(long anchorId)
+        {
+            CheckDisposed();
+            return ExternApi.sai_anchor_set_remove(_handle, anchorId);
+        }
+
+        /// <summary>
+        /// Get the latest corrected pose of an anchor.
+        /// </summary>
+        /// <returns>True if the anchor exists</returns>
+        public bool TryGetPose(long anchorId, out Pose anchorToWorld)
+        {
+            CheckDisposed();
+            return ExternApi.sai_anchor_set_get_pose(_handle, anchorId, out anchorToWorld);
+        }
+
+        /// <summary>
+        /// Recompute anchors from the updated keyframe poses. The native array is valid until
+        /// the next call, it is copied here so the returned array can be kept.
+        /// </summary>
+        /// <param name="output">Mapper output</param>
+        /// <returns>Anchors that moved</returns>
+        public AnchorUpdate[] Update(MapperOutput output)
+        {
+            CheckDisposed();
+            int n = ExternApi.sai_anchor_set_update(_handle, output.GetNativeHandle(), out IntPtr updatesHandle);
+            AnchorUpdate[] updates = new AnchorUpdate[n];
+            int anchorUpdateSize = Marshal.SizeOf<AnchorUpdate>();
+            for (int i = 0; i < n; i++)
+            {
+                updates[i] = Marshal.PtrToStructure<AnchorUpdate>(IntPtr.Add(updatesHandle, i * anchorUpdateSize));
+            }
+
+            return updates;
+        }
+
+        private void CheckDisposed()
+        {
+            if (_disposed)
+            {
+                throw new ObjectDisposedException(nameof(AnchorSet));
+            }
+        }
+
+        private struct ExternApi
+        {
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern IntPtr sai_anchor_set_create(
+                int keyFramesPerAnchor,
+                double minPositionChange,
+                double minAngleChange);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern long sai_anchor_set_add(
+                IntPtr anchorSetHandle,
+                IntPtr mapHandle,
+                Pose anchorToWorld);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_anchor_set_remove(IntPtr anchorSetHandle, long anchorId);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_anchor_set_get_pose(
+                IntPtr anchorSetHandle,
+                long anchorId,
+                [Out] out Pose anchorToWorld);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern int sai_anchor_set_get_count(IntPtr anchorSetHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern int sai_anchor_set_update(
+                IntPtr anchorSetHandle,
+                IntPtr mapperOutputHandle,
+                [Out] out IntPtr updatedAnchorsHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_anchor_set_release(IntPtr anchorSetHandle);
+        }
+    }
+}
@@ -0,0 +1,204 @@
+using System;
+using System.Runtime.InteropServices;
+using SpectacularAI.Native;
+
+namespace SpectacularAI.Mapping
+{
+    /// <summary>
+    /// Compact, quantised copy of a PointCloud: 16-bit positions relative to the keyframe's
+    /// bounding box, octahedral normals in 2 or 4 bytes and RGB565 colors. See compact.hpp
+    /// in the native plugin for the error bounds.
+    /// </summary>
+    public sealed class CompactPointCloud : IDisposable
+    {
+        [StructLayout(LayoutKind.Sequential)]
+        private struct Data
+        {
+            public int Size;
+            public int NormalBytes;
+            public Vector3f BoundsMin;
+            public Vector3f Scale;
+            public IntPtr Positions;
+            public IntPtr Normals;
+            public IntPtr Colors;
+            public long Bytes;
+        }
+
+        // Native handle to the CompactPointCloud
+        private readonly IntPtr _handle;
+
+        // To detect redundant calls to Dispose
+        private bool _disposed = false;
+
+        private readonly Data _data;
+
+        /// <summary>
+        /// Encode a point cloud.
+        /// </summary>
+        /// <param name="pointCloud">Source point cloud, can be disposed afterwards</param>
+        /// <param name="normalBytes">2 or 4 to keep the normals (if any), 0 to drop them</param>
+        public CompactPointCloud(PointCloud pointCloud, int normalBytes = 2)
+        {
+            if (normalBytes != 0 && normalBytes != 2 && normalBytes != 4)
+            {
+                throw new ArgumentException(nameof(normalBytes), "normalBytes must be 0, 2 or 4");
+            }
+
+            _handle = ExternApi.sai_point_cloud_encode_compact(pointCloud.GetNativeHandle(), normalBytes);
+            ExternApi.sai_compact_point_cloud_get(_handle, out _data);
+        }
+
+        /// <summary>
+        /// Releases the resources associated with the CompactPointCloud object.
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases unmanaged and - optionally - managed resources.
+        /// </summary>
+        private void Dispose(bool disposing)
+        {
+            if (!_disposed)
+            {
+                ExternApi.sai_compact_point_cloud_release(_handle);
+                _disposed = true;
+            }
+        }
+
+        /// <summary>
+        /// Finalizes an instance of the CompactPointCloud class.
+        /// </summary>
+        ~CompactPointCloud()
+        {
+            Dispose(false);
+        }
+
+        public int Size { get { return _data.Size; } }
+
+        /// <summary>
+        /// 0 if there are no normals, otherwise 2 or 4.
+        /// </summary>
+        public int NormalBytes { get { return _data.NormalBytes; } }
+
+        public bool HasColors { get { return _data.Colors != IntPtr.Zero; } }
+
+        /// <summary>
+        /// Quantisation origin, keyframe camera coordinates (SDK convention).
+        /// </summary>
+        public Vector3f BoundsMin { get { return _data.BoundsMin; } }
+
+        /// <summary>
+        /// Quantisation step per axis, decoded position = BoundsMin + q * Scale.
+        /// </summary>
+        public Vector3f Scale { get { return _data.Scale; } }
+
+        /// <summary>
+        /// Total size of the encoded buffers in bytes.
+        /// </summary>
+        public long Bytes { get { return _data.Bytes; } }
+
+        /// <summary>
+        /// Copy the quantised positions (3 per point), e.g. for a UNorm16 vertex buffer.
+        /// </summary>
+        public void CopyQuantizedPositions(ushort[] dst)
+        {
+            CheckDisposed();
+            if (Size > 0) Marshal.Copy(_data.Positions, (short[])(object)dst, 0, 3 * Size);
+        }
+
+        /// <summary>
+        /// Copy the RGB565 colors (1 per point). Does nothing if HasColors is false.
+        /// </summary>
+        public void CopyRGB565Colors(ushort[] dst)
+        {
+            CheckDisposed();
+            if (Size > 0 && HasColors) Marshal.Copy(_data.Colors, (short[])(object)dst, 0, Size);
+        }
+
+        /// <summary>
+        /// Decode positions into Unity's camera coordinates of the keyframe, as PointCloud.Positions.
+        /// </summary>
+        public UnityEngine.Vector3[] DecodePositions()
+        {
+            CheckDisposed();
+            Vector3f[] decoded = new Vector3f[Size];
+            ExternApi.sai_compact_point_cloud_decode_positions(_handle, decoded);
+            UnityEngine.Vector3[] positions = new UnityEngine.Vector3[Size];
+            for (int i = 0; i < Size; i++)
+            {
+                positions[i] = Utility.TransformCameraPointToUnity(decoded[i]);
+            }
+
+            return positions;
+        }
+
+        /// <summary>
+        /// Decode normals into Unity's camera coordinates, null if there are no normals.
+        /// </summary>
+        public UnityEngine.Vector3[] DecodeNormals()
+        {
+            CheckDisposed();
+            Vector3f[] decoded = new Vector3f[Size];
+            if (!ExternApi.sai_compact_point_cloud_decode_normals(_handle, decoded)) return null;
+            UnityEngine.Vector3[] normals = new UnityEngine.Vector3[Size];
+            for (int i = 0; i < Size; i++)
+            {
+                normals[i] = Utility.TransformCameraDirectionToUnity(decoded[i]);
+            }
+
+            return normals;
+        }
+
+        /// <summary>
+        /// Decode colors, null if there are no colors.
+        /// </summary>
+        public UnityEngine.Color32[] DecodeColors()
+        {
+            CheckDisposed();
+            UnityEngine.Color32[] colors = new UnityEngine.Color32[Size];
+            if (!ExternApi.sai_compact_point_cloud_decode_rgba32(_handle, colors)) return null;
+            return colors;
+        }
+
+        private void CheckDisposed()
+        {
+            if (_disposed)
+            {
+                throw new ObjectDisposedException(nameof(CompactPointCloud));
+            }
+        }
+
+        private struct ExternApi
+        {
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern IntPtr sai_point_cloud_encode_compact(IntPtr pointCloudHandle, int normalBytes);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_compact_point_cloud_get(IntPtr compactPointCloudHandle, [Out] out Data compactPointCloud);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_compact_point_cloud_decode_positions(
+                IntPtr compactPointCloudHandle,
+                [Out] Vector3f[] positions);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_compact_point_cloud_decode_normals(
+                IntPtr compactPointCloudHandle,
+                [Out] Vector3f[] normals);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_compact_point_cloud_decode_rgba32(
+                IntPtr compactPointCloudHandle,
+                [Out] UnityEngine.Color32[] colors);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_compact_point_cloud_release(IntPtr compactPointCloudHandle);
+        }
+    }
+}
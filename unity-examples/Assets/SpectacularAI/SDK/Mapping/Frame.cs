@@ -83,14 +83,95 @@ namespace SpectacularAI.Mapping
         }
 
         /// <summary>
-        /// Image data from the camera, might not always exist. 
-        /// TODO: implement, now always null
+        /// Image data from the camera, might not always exist (IntPtr.Zero).
+        /// Valid until this Frame is disposed, see ImageView for the layout.
         /// </summary>
         public IntPtr Image
         {
             get
             {
-                return IntPtr.Zero;
+                return ImageView.Data;
+            }
+        }
+
+        /// <summary>
+        /// Image dimensions, format and data pointer. Format is NONE if the frame has no image.
+        /// Valid until this Frame is disposed.
+        /// </summary>
+        public ImageView ImageView
+        {
+            get
+            {
+                CheckDisposed();
+                ExternApi.sai_frame_get_image(_handle, out ImageView imageView);
+                return imageView;
+            }
+        }
+
+        /// <summary>
+        /// Convert the image (GRAY8, RGB24 or RGBA32) into RGBA32, e.g. for Texture2D.LoadRawTextureData.
+        /// </summary>
+        /// <param name="dst">Destination, at least Width * Height * 4 bytes</param>
+        /// <param name="flipVertically">Write rows bottom-up as Unity textures expect</param>
+        /// <returns>False if there is no image or the format is not supported</returns>
+        public bool ConvertToRGBA32(byte[] dst, bool flipVertically = true)
+        {
+            CheckDisposed();
+            ImageView view = ImageView;
+            if (dst == null || dst.Length < view.Width * view.Height * 4) return false;
+            GCHandle pinned = GCHandle.Alloc(dst, GCHandleType.Pinned);
+            try
+            {
+                return ExternApi.sai_frame_convert_to_rgba32(_handle, pinned.AddrOfPinnedObject(), 0, flipVertically);
+            }
+            finally
+            {
+                pinned.Free();
+            }
+        }
+
+        /// <summary>
+        /// Convert the image (GRAY16 depth or GRAY8) into R16, e.g. for a TextureFormat.R16 texture.
+        /// </summary>
+        /// <param name="dst">Destination, at least Width * Height values</param>
+        /// <param name="flipVertically">Write rows bottom-up as Unity textures expect</param>
+        /// <returns>False if there is no image or the format is not supported</returns>
+        public bool ConvertToR16(ushort[] dst, bool flipVertically = true)
+        {
+            CheckDisposed();
+            ImageView view = ImageView;
+            if (dst == null || dst.Length < view.Width * view.Height) return false;
+            GCHandle pinned = GCHandle.Alloc(dst, GCHandleType.Pinned);
+            try
+            {
+                return ExternApi.sai_frame_convert_to_r16(_handle, pinned.AddrOfPinnedObject(), 0, flipVertically);
+            }
+            finally
+            {
+                pinned.Free();
+            }
+        }
+
+        /// <summary>
+        /// Downscale the image (GRAY8, RGB24 or RGBA32) into a RGBA32 thumbnail.
+        /// </summary>
+        /// <param name="dst">Destination, at least width * height * 4 bytes</param>
+        /// <param name="width">Thumbnail width</param>
+        /// <param name="height">Thumbnail height</param>
+        /// <param name="flipVertically">Write rows bottom-up as Unity textures expect</param>
+        /// <returns>False if there is no image or the format is not supported</returns>
+        public bool ConvertToRGBA32Thumbnail(byte[] dst, int width, int height, bool flipVertically = true)
+        {
+            CheckDisposed();
+            if (dst == null || dst.Length < width * height * 4) return false;
+            GCHandle pinned = GCHandle.Alloc(dst, GCHandleType.Pinned);
+            try
+            {
+                return ExternApi.sai_frame_convert_to_rgba32_thumbnail(_handle, pinned.AddrOfPinnedObject(), width, height, flipVertically);
+            }
+            finally
+            {
+                pinned.Free();
             }
         }
 
@@ -123,6 +204,35 @@ namespace SpectacularAI.Mapping
             [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
             public static extern double sai_frame_get_depth_scale(IntPtr frameHandle);
 
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_frame_get_image(IntPtr frameHandle, [Out] out ImageView imageView);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_frame_convert_to_rgba32(
+                IntPtr frameHandle,
+                IntPtr dst,
+                int dstStride,
+                [MarshalAs(UnmanagedType.I1)] bool flipVertically);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_frame_convert_to_r16(
+                IntPtr frameHandle,
+                IntPtr dst,
+                int dstStride,
+                [MarshalAs(UnmanagedType.I1)] bool flipVertically);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_frame_convert_to_rgba32_thumbnail(
+                IntPtr frameHandle,
+                IntPtr dst,
+                int dstWidth,
+                int dstHeight,
+                [MarshalAs(UnmanagedType.I1)] bool flipVertically);
+
             [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
             public static extern void sai_frame_release(IntPtr frameHandle);
         }
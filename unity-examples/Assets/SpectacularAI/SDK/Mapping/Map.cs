@@ -112,6 +112,11 @@ namespace SpectacularAI.Mapping
             }
         }
 
+        internal IntPtr GetNativeHandle()
+        {
+            return _handle;
+        }
+
         private struct ExternApi
         {
             [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
@@ -128,6 +128,11 @@ namespace SpectacularAI.Mapping
             }
         }
 
+        internal IntPtr GetNativeHandle()
+        {
+            return _handle;
+        }
+
         private struct ExternApi
         {
             [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
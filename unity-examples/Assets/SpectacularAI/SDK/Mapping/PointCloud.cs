@@ -200,6 +200,21 @@ namespace SpectacularAI.Mapping
             }
         }
 
+        /// <summary>
+        /// Encode into the compact, quantised representation. Must be disposed.
+        /// </summary>
+        /// <param name="normalBytes">2 or 4 to keep the normals (if any), 0 to drop them</param>
+        public CompactPointCloud EncodeCompact(int normalBytes = 2)
+        {
+            CheckDisposed();
+            return new CompactPointCloud(this, normalBytes);
+        }
+
+        internal IntPtr GetNativeHandle()
+        {
+            return _handle;
+        }
+
         private void CheckDisposed()
         {
             if (_disposed)
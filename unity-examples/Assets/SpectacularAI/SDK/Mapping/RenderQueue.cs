@@ -0,0 +1,338 @@
+using System;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using SpectacularAI.Native;
+
+namespace SpectacularAI.Mapping
+{
+    /// <summary>
+    /// Render-ready buffers of one keyframe, prepared by RenderQueue.
+    /// Positions and normals are in Unity's camera coordinates of the keyframe, colors are RGBA32.
+    /// </summary>
+    public sealed class RenderItem : IDisposable
+    {
+        [StructLayout(LayoutKind.Sequential)]
+        private struct Data
+        {
+            public long KeyFrameId;
+            [MarshalAs(UnmanagedType.I1)]
+            public bool Removed;
+            [MarshalAs(UnmanagedType.I1)]
+            public bool HasGeometry;
+            public Pose Pose;
+            public int VertexCount;
+            public IntPtr Positions;
+            public IntPtr Normals;
+            public IntPtr Colors;
+            public IntPtr Indices;
+            public long Bytes;
+            public double PreparationMs;
+        }
+
+        // Native handle to the RenderItem
+        private readonly IntPtr _handle;
+
+        // To detect redundant calls to Dispose
+        private bool _disposed = false;
+
+        private readonly Data _data;
+
+        /// <summary>
+        /// Initializes a new instance of the RenderItem class.
+        /// </summary>
+        /// <param name="handle">The native handle to the RenderItem.</param>
+        public RenderItem(IntPtr handle)
+        {
+            if (handle == IntPtr.Zero)
+            {
+                throw new ArgumentException(nameof(handle), "RenderItem handle cannot be IntPtr.Zero");
+            }
+
+            _handle = handle;
+            ExternApi.sai_render_item_get(_handle, out _data);
+        }
+
+        /// <summary>
+        /// Releases the resources associated with the RenderItem object.
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases unmanaged and - optionally - managed resources.
+        /// </summary>
+        private void Dispose(bool disposing)
+        {
+            if (!_disposed)
+            {
+                ExternApi.sai_render_item_release(_handle);
+                _disposed = true;
+            }
+        }
+
+        /// <summary>
+        /// Finalizes an instance of the RenderItem class.
+        /// </summary>
+        ~RenderItem()
+        {
+            Dispose(false);
+        }
+
+        public long KeyFrameId { get { return _data.KeyFrameId; } }
+
+        /// <summary>
+        /// Keyframe was deleted from the map, its mesh should be destroyed.
+        /// </summary>
+        public bool Removed { get { return _data.Removed; } }
+
+        /// <summary>
+        /// False when only the keyframe pose changed and the existing mesh can be kept.
+        /// </summary>
+        public bool HasGeometry { get { return _data.HasGeometry; } }
+
+        /// <summary>
+        /// Latest keyframe camera->world pose.
+        /// </summary>
+        public Pose Pose { get { return _data.Pose; } }
+
+        public int VertexCount { get { return _data.VertexCount; } }
+
+        public bool HasNormals { get { return _data.Normals != IntPtr.Zero; } }
+
+        public bool HasColors { get { return _data.Colors != IntPtr.Zero; } }
+
+        /// <summary>
+        /// Total size of the native buffers in bytes.
+        /// </summary>
+        public long Bytes { get { return _data.Bytes; } }
+
+        /// <summary>
+        /// Time a worker spent preparing this item.
+        /// </summary>
+        public double PreparationMs { get { return _data.PreparationMs; } }
+
+        /// <summary>
+        /// Copy positions (3 floats per vertex), e.g. for Mesh.SetVertexBufferData.
+        /// </summary>
+        public void CopyPositions(float[] dst)
+        {
+            CheckDisposed();
+            if (VertexCount > 0) Marshal.Copy(_data.Positions, dst, 0, 3 * VertexCount);
+        }
+
+        /// <summary>
+        /// Copy normals (3 floats per vertex). Does nothing if HasNormals is false.
+        /// </summary>
+        public void CopyNormals(float[] dst)
+        {
+            CheckDisposed();
+            if (VertexCount > 0 && HasNormals) Marshal.Copy(_data.Normals, dst, 0, 3 * VertexCount);
+        }
+
+        /// <summary>
+        /// Copy RGBA32 colors (4 bytes per vertex). Does nothing if HasColors is false.
+        /// </summary>
+        public void CopyColors(byte[] dst)
+        {
+            CheckDisposed();
+            if (VertexCount > 0 && HasColors) Marshal.Copy(_data.Colors, dst, 0, 4 * VertexCount);
+        }
+
+        /// <summary>
+        /// Copy 32-bit point indices (one per vertex).
+        /// </summary>
+        public void CopyIndices(int[] dst)
+        {
+            CheckDisposed();
+            if (VertexCount > 0) Marshal.Copy(_data.Indices, dst, 0, VertexCount);
+        }
+
+        private void CheckDisposed()
+        {
+            if (_disposed)
+            {
+                throw new ObjectDisposedException(nameof(RenderItem));
+            }
+        }
+
+        private struct ExternApi
+        {
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_render_item_get(IntPtr renderItemHandle, [Out] out Data renderItem);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_render_item_release(IntPtr renderItemHandle);
+        }
+    }
+
+    /// <summary>
+    /// RenderQueue statistics.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RenderQueueStats
+    {
+        /// <summary>
+        /// Keyframes waiting for or being prepared by workers
+        /// </summary>
+        public int PendingJobs;
+        public int ReadyItems;
+        public long ReadyBytes;
+        public long PreparedItems;
+
+        /// <summary>
+        /// Items superseded by a newer update before being pulled
+        /// </summary>
+        public long StaleItems;
+        public double MeanPreparationMs;
+        public double MaxPreparationMs;
+
+        public override string ToString()
+        {
+            return $"SpectacularAI.Mapping.RenderQueueStats (pending={PendingJobs}, ready={ReadyItems}, readyBytes={ReadyBytes}, " +
+                $"prepared={PreparedItems}, stale={StaleItems}, meanMs={MeanPreparationMs}, maxMs={MaxPreparationMs})";
+        }
+    }
+
+    /// <summary>
+    /// Prepares keyframe point cloud buffers on native worker threads. Push mapper outputs
+    /// in and call Drain from Update to pull finished items within a frame budget.
+    /// </summary>
+    public sealed class RenderQueue : IDisposable
+    {
+        // Native handle to the RenderQueue
+        private readonly IntPtr _handle;
+
+        // To detect redundant calls to Dispose
+        private bool _disposed = false;
+
+        private readonly Stopwatch _stopwatch = new Stopwatch();
+
+        /// <summary>
+        /// Initializes a new instance of the RenderQueue class.
+        /// </summary>
+        /// <param name="threadCount">Number of native worker threads.</param>
+        public RenderQueue(int threadCount = 2)
+        {
+            _handle = ExternApi.sai_render_queue_create(threadCount);
+        }
+
+        /// <summary>
+        /// Releases the resources associated with the RenderQueue object.
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases unmanaged and - optionally - managed resources.
+        /// </summary>
+        private void Dispose(bool disposing)
+        {
+            if (!_disposed)
+            {
+                ExternApi.sai_render_queue_release(_handle);
+                _disposed = true;
+            }
+        }
+
+        /// <summary>
+        /// Finalizes an instance of the RenderQueue class.
+        /// </summary>
+        ~RenderQueue()
+        {
+            Dispose(false);
+        }
+
+        /// <summary>
+        /// Queue the keyframes updated by the mapper output. Cheap, the work is done by workers.
+        /// The output can be disposed right after.
+        /// </summary>
+        public void Push(MapperOutput output)
+        {
+            CheckDisposed();
+            ExternApi.sai_render_queue_push(_handle, output.GetNativeHandle());
+        }
+
+        /// <summary>
+        /// Pull a single ready item, null if none. Must be disposed.
+        /// </summary>
+        public RenderItem TryPop()
+        {
+            CheckDisposed();
+            IntPtr itemHandle = ExternApi.sai_render_queue_try_pop(_handle);
+            if (itemHandle == IntPtr.Zero) return null;
+            return new RenderItem(itemHandle);
+        }
+
+        /// <summary>
+        /// Pull ready items and pass them to onItem until the time or byte budget is used up.
+        /// Items are disposed after onItem returns.
+        /// </summary>
+        /// <param name="timeBudgetMs">Time budget including the time spent in onItem</param>
+        /// <param name="byteBudget">Maximum total item size in bytes</param>
+        /// <param name="onItem">Called for each item, e.g. to upload it to a Mesh</param>
+        /// <returns>Number of items handled</returns>
+        public int Drain(double timeBudgetMs, long byteBudget, Action<RenderItem> onItem)
+        {
+            CheckDisposed();
+            _stopwatch.Restart();
+            long bytes = 0;
+            int count = 0;
+            while (_stopwatch.Elapsed.TotalMilliseconds < timeBudgetMs && bytes < byteBudget)
+            {
+                using (RenderItem item = TryPop())
+                {
+                    if (item == null) break;
+                    onItem(item);
+                    bytes += item.Bytes;
+                    count++;
+                }
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Queue backlog and preparation time statistics.
+        /// </summary>
+        public RenderQueueStats Stats
+        {
+            get
+            {
+                CheckDisposed();
+                return ExternApi.sai_render_queue_get_stats(_handle);
+            }
+        }
+
+        private void CheckDisposed()
+        {
+            if (_disposed)
+            {
+                throw new ObjectDisposedException(nameof(RenderQueue));
+            }
+        }
+
+        private struct ExternApi
+        {
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern IntPtr sai_render_queue_create(int threadCount);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_render_queue_push(IntPtr renderQueueHandle, IntPtr mapperOutputHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern IntPtr sai_render_queue_try_pop(IntPtr renderQueueHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern RenderQueueStats sai_render_queue_get_stats(IntPtr renderQueueHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_render_queue_release(IntPtr renderQueueHandle);
+        }
+    }
+}
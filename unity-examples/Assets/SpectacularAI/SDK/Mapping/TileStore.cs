@@ -0,0 +1,348 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+using SpectacularAI.Native;
+
+namespace SpectacularAI.Mapping
+{
+    /// <summary>
+    /// TileStore configuration.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public sealed class TileStoreConfiguration
+    {
+        /// <summary>
+        /// Local file for paged out tiles. Created or truncated, removed when the store is disposed.
+        /// </summary>
+        [MarshalAs(UnmanagedType.LPStr)]
+        public string PageFilePath = "";
+
+        /// <summary>
+        /// Tile edge length in meters. Tiles are square columns on the horizontal plane.
+        /// </summary>
+        public double TileSize = 10.0;
+
+        /// <summary>
+        /// Tiles within this distance (meters) of the camera are always kept in memory.
+        /// </summary>
+        public double ActiveRadius = 20.0;
+
+        /// <summary>
+        /// Tiles along the direction of travel are paged in this many seconds ahead.
+        /// </summary>
+        public double PrefetchSeconds = 3.0;
+
+        /// <summary>
+        /// Memory cap for resident point data in bytes. Active tiles may exceed it.
+        /// </summary>
+        public long MemoryCapBytes = 256 * 1024 * 1024;
+
+        /// <summary>
+        /// Store points quantised (see CompactPointCloud), 8 instead of 15 bytes per point.
+        /// </summary>
+        [MarshalAs(UnmanagedType.I1)]
+        public bool CompactPoints = true;
+    }
+
+    /// <summary>
+    /// Tile of a TileStore.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TileInfo
+    {
+        /// <summary>
+        /// Tile index, the tile covers [X, X + 1) * TileSize in SDK world x
+        /// </summary>
+        public int X;
+
+        /// <summary>
+        /// Tile index in SDK world y (Unity z)
+        /// </summary>
+        public int Y;
+
+        [MarshalAs(UnmanagedType.I1)]
+        public bool Resident;
+
+        /// <summary>
+        /// Resident copy differs from the page file
+        /// </summary>
+        [MarshalAs(UnmanagedType.I1)]
+        public bool Dirty;
+
+        public int KeyFrameCount;
+        public int PointCount;
+
+        /// <summary>
+        /// Size in memory when resident
+        /// </summary>
+        public long Bytes;
+    }
+
+    /// <summary>
+    /// TileStore residency and I/O statistics.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TileStoreStats
+    {
+        public int Tiles;
+        public int ResidentTiles;
+        public int DirtyTiles;
+        public int PendingJobs;
+        public long KeyFrames;
+        public long Points;
+        public long ResidentBytes;
+        public long MemoryCapBytes;
+        public long Loads;
+
+        /// <summary>
+        /// Tiles loaded ahead of the camera
+        /// </summary>
+        public long PrefetchLoads;
+
+        /// <summary>
+        /// Prefetched tiles that reached the active radius while still resident
+        /// </summary>
+        public long PrefetchHits;
+
+        /// <summary>
+        /// Tiles loaded only after they were already within the active radius
+        /// </summary>
+        public long ActiveMisses;
+
+        /// <summary>
+        /// Tiles loaded to apply a keyframe update to a paged out tile
+        /// </summary>
+        public long DemandLoads;
+        public long Evictions;
+
+        /// <summary>
+        /// Keyframe updates and removals dropped because a tile could not be read back from the page file
+        /// </summary>
+        public long FailedUpdates;
+
+        public long Writes;
+        public long BytesRead;
+        public long BytesWritten;
+        public long PageFileBytes;
+
+        /// <summary>
+        /// Page file bytes in abandoned slots waiting to be reused
+        /// </summary>
+        public long PageFileDeadBytes;
+        public double MeanLoadMs;
+        public double MaxLoadMs;
+
+        public override string ToString()
+        {
+            return $"SpectacularAI.Mapping.TileStoreStats (tiles={Tiles}, resident={ResidentTiles}, dirty={DirtyTiles}, " +
+                $"residentBytes={ResidentBytes}/{MemoryCapBytes}, loads={Loads}, prefetchLoads={PrefetchLoads}, " +
+                $"prefetchHits={PrefetchHits}, activeMisses={ActiveMisses}, evictions={Evictions}, failedUpdates={FailedUpdates}, " +
+                $"read={BytesRead}, written={BytesWritten}, pageFile={PageFileBytes}, dead={PageFileDeadBytes}, meanLoadMs={MeanLoadMs})";
+        }
+    }
+
+    /// <summary>
+    /// Spatially tiled, out-of-core store for large maps. Keeps keyframe poses and their
+    /// world points in tiles, pages tiles far from the camera out to a local file and
+    /// prefetches tiles along the direction of travel. Mapper outputs can be disposed right
+    /// after Ingest.
+    /// </summary>
+    public sealed class TileStore : IDisposable
+    {
+        // Native handle to the TileStore
+        private readonly IntPtr _handle;
+
+        // To detect redundant calls to Dispose
+        private bool _disposed = false;
+
+        /// <summary>
+        /// Initializes a new instance of the TileStore class.
+        /// </summary>
+        public TileStore(TileStoreConfiguration configuration)
+        {
+            var buffer = new StringBuilder(1000);
+            _handle = ExternApi.sai_tile_store_create(configuration, buffer);
+            if (_handle == IntPtr.Zero)
+            {
+                throw new Exception(buffer.ToString());
+            }
+        }
+
+        /// <summary>
+        /// Releases the resources associated with the TileStore object.
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases unmanaged and - optionally - managed resources.
+        /// </summary>
+        private void Dispose(bool disposing)
+        {
+            if (!_disposed)
+            {
+                ExternApi.sai_tile_store_release(_handle);
+                _disposed = true;
+            }
+        }
+
+        /// <summary>
+        /// Finalizes an instance of the TileStore class.
+        /// </summary>
+        ~TileStore()
+        {
+            Dispose(false);
+        }
+
+        /// <summary>
+        /// Queue the keyframes updated by the mapper output, applied by a worker thread.
+        /// </summary>
+        public void Ingest(MapperOutput output)
+        {
+            CheckDisposed();
+            ExternApi.sai_tile_store_ingest(_handle, output.GetNativeHandle());
+        }
+
+        /// <summary>
+        /// Page tiles in and out around the current camera position.
+        /// </summary>
+        public void UpdatePosition(VioOutput output)
+        {
+            CheckDisposed();
+            ExternApi.sai_tile_store_update_position(_handle, output.GetNativeHandle());
+        }
+
+        /// <summary>
+        /// Block until queued work is done and dirty tiles are written to the page file.
+        /// </summary>
+        public void Flush()
+        {
+            CheckDisposed();
+            ExternApi.sai_tile_store_flush(_handle);
+        }
+
+        /// <summary>
+        /// Write all points, resident or not, as a binary PLY file in Spectacular AI world
+        /// coordinates (z-up) with RGB colors. Blocks until queued work is done.
+        /// </summary>
+        public void ExportPly(string path)
+        {
+            CheckDisposed();
+            var buffer = new StringBuilder(1000);
+            if (!ExternApi.sai_tile_store_export_ply(_handle, path, buffer))
+            {
+                throw new Exception(buffer.ToString());
+            }
+        }
+
+        /// <summary>
+        /// Snapshot of all tiles.
+        /// </summary>
+        public TileInfo[] Tiles
+        {
+            get
+            {
+                CheckDisposed();
+                int n = ExternApi.sai_tile_store_get_tiles(_handle, out IntPtr tilesHandle);
+                TileInfo[] tiles = new TileInfo[n];
+                int tileInfoSize = Marshal.SizeOf<TileInfo>();
+                for (int i = 0; i < n; i++)
+                {
+                    tiles[i] = Marshal.PtrToStructure<TileInfo>(IntPtr.Add(tilesHandle, i * tileInfoSize));
+                }
+
+                return tiles;
+            }
+        }
+
+        /// <summary>
+        /// Copy the points of a resident tile.
+        /// </summary>
+        /// <param name="positions">Unity world coordinates, 3 floats per point</param>
+        /// <param name="colors">RGBA32 colors, 4 bytes per point, or null</param>
+        /// <returns>Number of points in the tile (may exceed the buffers), or -1 if the tile is not resident</returns>
+        public int CopyTilePoints(int tileX, int tileY, float[] positions, byte[] colors)
+        {
+            CheckDisposed();
+            int capacity = positions == null ? 0 : positions.Length / 3;
+            if (colors != null) capacity = Math.Min(capacity, colors.Length / 4);
+            return ExternApi.sai_tile_store_copy_tile_points(_handle, tileX, tileY, positions, colors, capacity);
+        }
+
+        /// <summary>
+        /// Latest camera->world pose of a keyframe, also when its tile is paged out.
+        /// </summary>
+        public bool TryGetKeyFramePose(long keyFrameId, out Pose cameraToWorld)
+        {
+            CheckDisposed();
+            return ExternApi.sai_tile_store_get_key_frame_pose(_handle, keyFrameId, out cameraToWorld);
+        }
+
+        /// <summary>
+        /// Residency and I/O statistics.
+        /// </summary>
+        public TileStoreStats Stats
+        {
+            get
+            {
+                CheckDisposed();
+                return ExternApi.sai_tile_store_get_stats(_handle);
+            }
+        }
+
+        private void CheckDisposed()
+        {
+            if (_disposed)
+            {
+                throw new ObjectDisposedException(nameof(TileStore));
+            }
+        }
+
+        private struct ExternApi
+        {
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern IntPtr sai_tile_store_create([In] TileStoreConfiguration configuration, StringBuilder errorMsg);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_tile_store_ingest(IntPtr tileStoreHandle, IntPtr mapperOutputHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_tile_store_update_position(IntPtr tileStoreHandle, IntPtr vioOutputHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_tile_store_flush(IntPtr tileStoreHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_tile_store_export_ply(IntPtr tileStoreHandle, string path, StringBuilder errorMsg);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern int sai_tile_store_get_tiles(IntPtr tileStoreHandle, [Out] out IntPtr tilesHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern int sai_tile_store_copy_tile_points(
+                IntPtr tileStoreHandle,
+                int tileX,
+                int tileY,
+                float[] positions,
+                byte[] colors,
+                int capacity);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_tile_store_get_key_frame_pose(
+                IntPtr tileStoreHandle,
+                long keyFrameId,
+                [Out] out Pose cameraToWorld);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern TileStoreStats sai_tile_store_get_stats(IntPtr tileStoreHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_tile_store_release(IntPtr tileStoreHandle);
+        }
+    }
+}
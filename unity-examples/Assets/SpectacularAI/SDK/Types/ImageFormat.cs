@@ -0,0 +1,19 @@
+namespace SpectacularAI
+{
+    /// <summary>
+    /// Pixel format of an ImageView
+    /// </summary>
+    public enum ImageFormat
+    {
+        /** No image or unsupported format */
+        NONE = 0,
+        /** 8-bit gray */
+        GRAY8 = 1,
+        /** 16-bit gray, e.g. depth (see Frame.DepthScale) */
+        GRAY16 = 2,
+        /** 24-bit RGB */
+        RGB24 = 3,
+        /** 32-bit RGBA */
+        RGBA32 = 4
+    }
+}
\ No newline at end of file
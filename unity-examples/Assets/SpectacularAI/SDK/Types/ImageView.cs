@@ -0,0 +1,32 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace SpectacularAI
+{
+    /// <summary>
+    /// Read-only view to native image data. Data is valid until the owning Frame is disposed.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ImageView
+    {
+        public int Width;
+        public int Height;
+
+        /// <summary>
+        /// Bytes per row
+        /// </summary>
+        public int Stride;
+
+        public ImageFormat Format;
+
+        /// <summary>
+        /// Pointer to the first pixel of the top row
+        /// </summary>
+        public IntPtr Data;
+
+        public override string ToString()
+        {
+            return $"SpectacularAI.ImageView (width={Width}, height={Height}, stride={Stride}, format={Format})";
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+using SpectacularAI.Native;
+
+namespace SpectacularAI.DepthAI
+{
+    /// <summary>
+    /// How samples within one fusion period are combined.
+    /// </summary>
+    public enum ExternalPoseMerge
+    {
+        /// <summary>Forward the newest sample of each period</summary>
+        Latest = 0,
+        /// <summary>Forward the inverse-variance weighted mean of the period's samples</summary>
+        Average = 1
+    }
+
+    /// <summary>
+    /// ExternalPoseQueue settings.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public sealed class ExternalPoseQueueConfiguration
+    {
+        /// <summary>
+        /// Poses forwarded to VIO per second, 0 forwards every accepted sample.
+        /// </summary>
+        public double FusionRateHz = 10.0;
+
+        public ExternalPoseMerge Merge = ExternalPoseMerge.Average;
+
+        /// <summary>
+        /// Samples further than this (meters, plus three standard deviations) from VIO are rejected, 0 disables.
+        /// </summary>
+        public double MaxPositionError = 0.5;
+
+        /// <summary>
+        /// Samples with known orientation further than this from VIO are rejected, 0 disables.
+        /// </summary>
+        public double MaxOrientationErrorDegrees = 10.0;
+
+        /// <summary>
+        /// How far in seconds VIO outputs may be extrapolated to check a sample.
+        /// </summary>
+        public double MaxTimeOffset = 0.25;
+
+        /// <summary>
+        /// Outliers are checked only after this many poses have been forwarded.
+        /// </summary>
+        public int GateAfterForwarded = 5;
+
+        /// <summary>
+        /// After this many consecutive outliers VIO is assumed to have drifted and the check is
+        /// restarted as if nothing had been forwarded yet, 0 never restarts it.
+        /// </summary>
+        public int ReacquireAfterRejections = 50;
+
+        /// <summary>
+        /// Maximum number of pending samples, the rest are dropped.
+        /// </summary>
+        public int Capacity = 4096;
+    }
+
+    /// <summary>
+    /// Timestamped external pose in Spectacular AI world coordinates.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ExternalPose
+    {
+        public Pose Pose;
+        public Matrix3d PositionCovariance;
+
+        /// <summary>
+        /// Negative if the orientation is unknown.
+        /// </summary>
+        public double OrientationVariance;
+
+        public ExternalPose(Pose pose, Matrix3d positionCovariance, double orientationVariance = -1)
+        {
+            Pose = pose;
+            PositionCovariance = positionCovariance;
+            OrientationVariance = orientationVariance;
+        }
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ExternalPoseQueueStats
+    {
+        public long Received;
+        public long Accepted;
+        public long Rejected;
+
+        /// <summary>
+        /// Outlier checks restarted after ReacquireAfterRejections consecutive outliers
+        /// </summary>
+        public long Reacquisitions;
+        public long Decimated;
+        public long Dropped;
+        public long Forwarded;
+        public int Pending;
+        public double MeanForwardMs;
+        public double MaxForwardMs;
+
+        public override string ToString()
+        {
+            return $"ExternalPoseQueueStats(received={Received}, accepted={Accepted}, rejected={Rejected}, " +
+                $"reacquisitions={Reacquisitions}, decimated={Decimated}, dropped={Dropped}, forwarded={Forwarded}, " +
+                $"pending={Pending}, meanForwardMs={MeanForwardMs}, maxForwardMs={MaxForwardMs})";
+        }
+    }
+
+    /// <summary>
+    /// Buffered ingestion of external absolute poses. Batches are queued without blocking and
+    /// a native worker thread rejects outliers against VIO, merges samples to the fusion rate
+    /// and forwards them to Session.AddAbsolutePose. Disposing the session also disposes its
+    /// live queues.
+    /// </summary>
+    public sealed class ExternalPoseQueue : IDisposable
+    {
+        // Native handle to the ExternalPoseQueue
+        private readonly IntPtr _handle;
+
+        // To detect redundant calls to Dispose
+        private bool _disposed = false;
+
+        // The native queue forwards into this session, which releases the queue before itself
+        private readonly Session _session;
+
+        public ExternalPoseQueue(Session session, ExternalPoseQueueConfiguration configuration = null)
+        {
+            if (configuration == null) configuration = new ExternalPoseQueueConfiguration();
+            var buffer = new StringBuilder(1000);
+            _handle = ExternApi.sai_external_pose_queue_create(session.GetNativeHandle(), configuration, buffer);
+            if (_handle == IntPtr.Zero)
+            {
+                throw new Exception(buffer.ToString());
+            }
+            _session = session;
+            _session.AddExternalPoseQueue(this);
+        }
+
+        /// <summary>
+        /// Releases the resources associated with the ExternalPoseQueue object.
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases unmanaged and - optionally - managed resources.
+        /// </summary>
+        private void Dispose(bool disposing)
+        {
+            if (!_disposed)
+            {
+                ExternApi.sai_external_pose_queue_release(_handle);
+                _session.RemoveExternalPoseQueue(this);
+                _disposed = true;
+            }
+        }
+
+        /// <summary>
+        /// Finalizes an instance of the ExternalPoseQueue class.
+        /// </summary>
+        ~ExternalPoseQueue()
+        {
+            Dispose(false);
+        }
+
+        /// <summary>
+        /// Latest VIO estimate for the outlier check, call with every session output.
+        /// </summary>
+        public void AddVioOutput(VioOutput output)
+        {
+            CheckDisposed();
+            ExternApi.sai_external_pose_queue_add_vio_output(_handle, output.GetNativeHandle());
+        }
+
+        /// <summary>
+        /// Queue samples ordered by time in a single native call.
+        /// </summary>
+        /// <param name="count">Number of samples to queue from the start of the array, all if negative</param>
+        /// <returns>Number of samples queued, the rest were dropped because the queue was full</returns>
+        public int Push(ExternalPose[] poses, int count = -1)
+        {
+            CheckDisposed();
+            if (count < 0 || count > poses.Length) count = poses.Length;
+            return ExternApi.sai_external_pose_queue_push(_handle, poses, count);
+        }
+
+        /// <summary>
+        /// Block until queued samples have been processed and forwarded.
+        /// </summary>
+        public void Flush()
+        {
+            CheckDisposed();
+            ExternApi.sai_external_pose_queue_flush(_handle);
+        }
+
+        public ExternalPoseQueueStats Stats
+        {
+            get
+            {
+                CheckDisposed();
+                return ExternApi.sai_external_pose_queue_get_stats(_handle);
+            }
+        }
+
+        private void CheckDisposed()
+        {
+            if (_disposed)
+            {
+                throw new ObjectDisposedException(nameof(ExternalPoseQueue));
+            }
+        }
+
+        private struct ExternApi
+        {
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern IntPtr sai_external_pose_queue_create(
+                IntPtr sessionHandle,
+                [In] ExternalPoseQueueConfiguration configuration,
+                StringBuilder errorMsg);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_external_pose_queue_add_vio_output(IntPtr queueHandle, IntPtr vioOutputHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern int sai_external_pose_queue_push(
+                IntPtr queueHandle,
+                [In] ExternalPose[] poses,
+                int count);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_external_pose_queue_flush(IntPtr queueHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern ExternalPoseQueueStats sai_external_pose_queue_get_stats(IntPtr queueHandle);
+
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            public static extern void sai_external_pose_queue_release(IntPtr queueHandle);
+        }
+    }
+}
@@ -0,0 +1,129 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace SpectacularAI.DepthAI
+{
+    /// <summary>
+    /// Path of the synthetic device. The device starts at the origin and faces along the direction of travel.
+    /// </summary>
+    public enum MockTrajectory
+    {
+        Static = 0,
+        Line = 1,
+        Circle = 2,
+        FigureEight = 3
+    }
+
+    /// <summary>
+    /// Synthetic backend that needs no OAK device, see Pipeline. Sessions generate VIO outputs along
+    /// a scripted trajectory and, when the mapping API is enabled, keyframes with point clouds.
+    /// </summary>
+    [Serializable]
+    [StructLayout(LayoutKind.Sequential)]
+    public sealed class MockBackendConfiguration
+    {
+        /// <summary>
+        /// VIO output rate, capped at the configured gyroscope rate.
+        /// </summary>
+        public double OutputRateHz = 100.0;
+
+        /// <summary>
+        /// When false, outputs are produced as fast as they are consumed instead of at OutputRateHz.
+        /// </summary>
+        [MarshalAs(UnmanagedType.I1)]
+        public bool RealTime = true;
+
+        public MockTrajectory Trajectory = MockTrajectory.Circle;
+
+        /// <summary>
+        /// Speed along the trajectory in m/s.
+        /// </summary>
+        public double Speed = 1.0;
+
+        /// <summary>
+        /// Size of the circle and figure eight in meters.
+        /// </summary>
+        public double Radius = 2.0;
+
+        /// <summary>
+        /// Tracking status is INIT this long before TRACKING.
+        /// </summary>
+        public double InitSeconds = 0.5;
+
+        /// <summary>
+        /// Seconds of tracking between LOST_TRACKING periods, 0 disables them.
+        /// </summary>
+        public double LostTrackingIntervalSeconds = 0.0;
+
+        public double LostTrackingSeconds = 1.0;
+
+        /// <summary>
+        /// Standard deviation of gaussian position noise in meters.
+        /// </summary>
+        public double PositionNoise = 0.0;
+
+        /// <summary>
+        /// Maximum extra delivery delay per output in seconds, real time only.
+        /// </summary>
+        public double TimingJitterSeconds = 0.0;
+
+        /// <summary>
+        /// In real time the oldest outputs are dropped when the queue is full, otherwise the generator waits.
+        /// </summary>
+        public int MaxQueuedOutputs = 1000;
+
+        /// <summary>
+        /// Keyframes per second while tracking, requires the mapping API.
+        /// </summary>
+        public double KeyFrameRateHz = 2.0;
+
+        public int PointsPerKeyFrame = 2000;
+
+        [MarshalAs(UnmanagedType.I1)]
+        public bool PointNormals = true;
+
+        [MarshalAs(UnmanagedType.I1)]
+        public bool PointColors = true;
+
+        /// <summary>
+        /// Older keyframes are removed from the map, 0 keeps all.
+        /// </summary>
+        public int MaxKeyFrames = 0;
+
+        /// <summary>
+        /// Primary frame images (GRAY8) are generated when both are positive.
+        /// </summary>
+        public int ImageWidth = 0;
+
+        public int ImageHeight = 0;
+
+        public uint Seed = 1;
+    }
+
+    /// <summary>
+    /// Counters of a mock session, see Session.TryGetMockStats.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MockSessionStats
+    {
+        public long Outputs;
+        public long TriggerOutputs;
+        public long DroppedOutputs;
+        public int QueuedOutputs;
+        public int TrackingStatusChanges;
+        public long KeyFrames;
+        public long MapperOutputs;
+        public long Points;
+        public long AbsolutePoses;
+        public double SimulatedSeconds;
+        public double WallSeconds;
+
+        public override string ToString()
+        {
+            return $"MockSessionStats(outputs={Outputs}, triggerOutputs={TriggerOutputs}, dropped={DroppedOutputs}, " +
+                $"queued={QueuedOutputs}, statusChanges={TrackingStatusChanges}, keyFrames={KeyFrames}, " +
+                $"mapperOutputs={MapperOutputs}, points={Points}, absolutePoses={AbsolutePoses}, " +
+                $"simulated={SimulatedSeconds}s, wall={WallSeconds}s)";
+        }
+    }
+}
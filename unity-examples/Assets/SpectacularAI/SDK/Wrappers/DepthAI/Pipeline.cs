@@ -26,10 +26,12 @@ namespace SpectacularAI.DepthAI
         /// <param name="configuration">Optional. Define Pipeline configuration.</param>
         /// <param name="internalParameters">Optional. Define internal VIO parameters.</param>
         /// <param name="enableMappingAPI">Optional. Set true to enable mapping API.</param>
+        /// <param name="mockBackend">Optional. When set, use a synthetic backend instead of an OAK device.</param>
         public Pipeline(
             Configuration configuration = null,
             VioParameter[] internalParameters = null,
-            bool enableMappingAPI = false)
+            bool enableMappingAPI = false,
+            MockBackendConfiguration mockBackend = null)
         {
             if (configuration == null) configuration = new Configuration();
             if (internalParameters == null) internalParameters = new VioParameter[0];
@@ -47,7 +49,8 @@ namespace SpectacularAI.DepthAI
                 configuration,
                 internalParameters,
                 internalParameters.Length,
-                _mapperOutputCallback);
+                _mapperOutputCallback,
+                mockBackend);
         }
 
         /// <summary>
@@ -117,7 +120,8 @@ namespace SpectacularAI.DepthAI
                 [In] Configuration configuration,
                 VioParameter[] vioParameters,
                 int internalParametersCount,
-                CallbackDelegate onMapperOutput);
+                CallbackDelegate onMapperOutput,
+                [In] MockBackendConfiguration mockBackend);
 
             [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
             public static extern IntPtr sai_depthai_pipeline_start_session(IntPtr pipelineHandle, StringBuilder errorMsg);
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Runtime.InteropServices;
 using SpectacularAI.Native;
 
@@ -15,6 +16,9 @@ namespace SpectacularAI.DepthAI
         // To detect redundant calls to Dispose
         private bool _disposed = false;
 
+        // Live queues forwarding into the native session, released before it
+        private readonly List<ExternalPoseQueue> _externalPoseQueues = new List<ExternalPoseQueue>();
+
         /// <summary>
         /// Initializes a new instance of the Session class.
         /// </summary>
@@ -45,9 +49,17 @@ namespace SpectacularAI.DepthAI
         {
             if (!_disposed)
             {
-                if (disposing)
+                // Also when finalizing: the queues' worker threads call into the native session,
+                // and finalization order between the session and its queues is undefined
+                ExternalPoseQueue[] queues;
+                lock (_externalPoseQueues)
+                {
+                    queues = _externalPoseQueues.ToArray();
+                    _externalPoseQueues.Clear();
+                }
+                foreach (ExternalPoseQueue queue in queues)
                 {
-                    // No managed resources to release in this case
+                    queue.Dispose();
                 }
 
                 ExternApi.sai_depthai_session_release(_handle);
@@ -144,6 +156,38 @@ namespace SpectacularAI.DepthAI
             return new CameraPose(cameraPoseHandle);
         }
 
+        /// <summary>
+        /// Counters of a session started with a mock backend.
+        /// </summary>
+        /// <returns>False if the session was not started from a mock pipeline</returns>
+        public bool TryGetMockStats(out MockSessionStats stats)
+        {
+            CheckDisposed();
+            return ExternApi.sai_depthai_session_get_mock_stats(_handle, out stats);
+        }
+
+        internal IntPtr GetNativeHandle()
+        {
+            CheckDisposed();
+            return _handle;
+        }
+
+        internal void AddExternalPoseQueue(ExternalPoseQueue queue)
+        {
+            lock (_externalPoseQueues)
+            {
+                _externalPoseQueues.Add(queue);
+            }
+        }
+
+        internal void RemoveExternalPoseQueue(ExternalPoseQueue queue)
+        {
+            lock (_externalPoseQueues)
+            {
+                _externalPoseQueues.Remove(queue);
+            }
+        }
+
         private void CheckDisposed()
         {
             if (_disposed)
@@ -181,6 +225,10 @@ namespace SpectacularAI.DepthAI
                 IntPtr sessionHandle,
                 IntPtr vioOutputHandle);
 
+            [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool sai_depthai_session_get_mock_stats(IntPtr sessionHandle, [Out] out MockSessionStats stats);
+
             [DllImport(ApiConstants.saiNativeApi, CallingConvention = ApiConstants.saiCallingConvention)]
             public static extern void sai_depthai_session_release(IntPtr sessionHandle);
         }
@@ -63,6 +63,12 @@ namespace SpectacularAI.DepthAI
         [Tooltip("Internal algorithm parameters")]
         public List<VioParameter> InternalParameters;
 
+        [Tooltip("Use a synthetic backend instead of an OAK device")]
+        public bool UseMockBackend = false;
+
+        [Tooltip("Synthetic backend settings, used when UseMockBackend is enabled")]
+        public MockBackendConfiguration MockBackend = new MockBackendConfiguration();
+
         private Pipeline _pipeline;
         private Session _session;
 
@@ -85,7 +91,11 @@ namespace SpectacularAI.DepthAI
             config.RecordingFolder = RecordingFolder;
             config.AprilTagPath = AprilTagPath;
 
-            _pipeline = new Pipeline(configuration: config, enableMappingAPI: MappingAPI, internalParameters: InternalParameters.ToArray());
+            _pipeline = new Pipeline(
+                configuration: config,
+                enableMappingAPI: MappingAPI,
+                internalParameters: InternalParameters.ToArray(),
+                mockBackend: UseMockBackend ? MockBackend : null);
             _session = _pipeline.StartSession();
         }
         